@@ -134,8 +134,8 @@ TEST(Benchmark, Jitters) {
         jit_->generate_code(B_ROW_MAJOR, m, k, n);
         for (index_t i = 0; i < iterations; ++i) {
 #ifdef ENABLE_JIT
-          MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, k, B_ROW_MAJOR, n,
-                        0, C, n, jit_);
+          MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, m, B_ROW_MAJOR, n,
+                        0, C, m, jit_);
 #else
           MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, k, B_ROW_MAJOR, n,
                         0, C, n);
@@ -394,8 +394,8 @@ TEST(Benchmark, JitterOverhead) {
         end = std::chrono::steady_clock::now();
         for (index_t i = 0; i < iterations; ++i) {
 #ifdef ENABLE_JIT
-          MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, k, B_ROW_MAJOR, n,
-                        0, C, n, jit_);
+          MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, m, B_ROW_MAJOR, n,
+                        0, C, m, jit_);
 #else
           MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, k, B_ROW_MAJOR, n,
                         0, C, n);
@@ -529,7 +529,7 @@ TEST(Benchmark, WinogradJIT) {
         initialize_tensor(filter);
 
 #ifdef ENABLE_JIT
-        const index_t in_tile_area = 16;
+        const index_t in_tile_area = winograd.TILE_AREA;
         std::shared_ptr<Tensor<float>> transformed_filter =
             std::make_shared<Tensor<float>>();
         transformed_filter->resize({out_channels, in_channels, in_tile_area});
@@ -619,4 +619,152 @@ TEST(Benchmark, WinogradJIT) {
 #endif
   tofile(filename, results, height, width, header);
   free(results);
-}
\ No newline at end of file
+}
+TEST(Benchmark, Prefetch) {
+#ifdef ENABLE_JIT
+  // A prefetch distances (in A columns) evaluated for each M
+  const std::vector<index_t> vdistances = {0, 2, 4, 8, 16, 32};
+  const std::vector<index_t> vm = {16, 64, 256, 1024, 4096};
+  const index_t n = 64;
+  const index_t k = 256;
+  const index_t iterations = 100;
+
+  // vars in line: m, n, k, distance 0, ..., distance N
+  const index_t width = 3 + vdistances.size();
+  const index_t height = vm.size();
+  double *results =
+      static_cast<double *>(aligned_alloc(height * width, sizeof(double)));
+  memset(results, 0, sizeof(double) * height * width);
+
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+  std::chrono::nanoseconds duration;
+
+  for (index_t mi = 0; mi < vm.size(); ++mi) {
+    const index_t m = vm[mi];
+    float *A = static_cast<float *>(
+        _mm_malloc(m * k * sizeof(float), ALIGN_BYTE_SIZE));
+    float *B = static_cast<float *>(
+        _mm_malloc(k * n * sizeof(float), ALIGN_BYTE_SIZE));
+    float *C = static_cast<float *>(
+        _mm_malloc(m * n * sizeof(float), ALIGN_BYTE_SIZE));
+    for (index_t i = 0; i < m * k; ++i) {
+      A[i] = i % 17;
+    }
+    for (index_t i = 0; i < k * n; ++i) {
+      B[i] = sparsity_adjustment(0);
+    }
+
+    std::shared_ptr<Jitter<float>> jit_ = std::make_shared<Jitter<float>>();
+    jit_->generate_code(B, m, k, n);
+    results[mi * width] = m;
+    results[mi * width + 1] = n;
+    results[mi * width + 2] = k;
+
+    for (index_t d = 0; d < vdistances.size(); ++d) {
+      jit_->set_prefetch_distance(vdistances[d]);
+      // warm up
+      MARLIN::sgemm('N', 'N', m, n, k, 1.0, A, m, B, n, 0, C, m, jit_);
+      begin = std::chrono::steady_clock::now();
+      for (index_t i = 0; i < iterations; ++i) {
+        MARLIN::sgemm('N', 'N', m, n, k, 1.0, A, m, B, n, 0, C, m, jit_);
+      }
+      end = std::chrono::steady_clock::now();
+      duration =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+      results[mi * width + 3 + d] = duration.count() / (iterations * 1000.0f);
+    }
+
+    _mm_free(A);
+    _mm_free(B);
+    _mm_free(C);
+  }
+
+  std::stringstream stream;
+  stream << "n" << n << "_k" << k << "_" << iterations << "_"
+         << std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+  std::string header = "IDX,M,N,K";
+  for (index_t distance : vdistances) {
+    header += ",PF" + std::to_string(distance);
+  }
+  tofile("build/results/prefetch_results_" + stream.str() + ".csv", results,
+         height, width, header);
+  aligned_free(results);
+#endif
+}
+
+TEST(Benchmark, Transpose) {
+  // shapes of test/mat followed by sizes that exceed the caches
+  const std::vector<std::pair<index_t, index_t>> vshapes = {
+      {10, 10}, {16, 16}, {37, 21}, {150, 131}, {256, 256}, {1024, 1024},
+      {4096, 1024}};
+  const index_t iterations = 100;
+
+  // vars in line: rows, cols, scalar, blocked, stream, parallel, in place
+  const index_t width = 7;
+  const index_t height = vshapes.size();
+  double *results =
+      static_cast<double *>(aligned_alloc(height * width, sizeof(double)));
+  memset(results, 0, sizeof(double) * height * width);
+
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+  std::chrono::nanoseconds duration;
+
+  auto measure = [&](auto &&transpose) {
+    // warm up
+    transpose();
+    begin = std::chrono::steady_clock::now();
+    for (index_t i = 0; i < iterations; ++i) {
+      transpose();
+    }
+    end = std::chrono::steady_clock::now();
+    duration =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+    return duration.count() / (iterations * 1000.0f);
+  };
+
+  for (index_t si = 0; si < vshapes.size(); ++si) {
+    const index_t h = vshapes[si].first;
+    const index_t w = vshapes[si].second;
+    float *src = static_cast<float *>(
+        _mm_malloc(h * w * sizeof(float), ALIGN_BYTE_SIZE));
+    float *dst = static_cast<float *>(
+        _mm_malloc(h * w * sizeof(float), ALIGN_BYTE_SIZE));
+    for (index_t i = 0; i < h * w; ++i) {
+      src[i] = i;
+    }
+    results[si * width] = h;
+    results[si * width + 1] = w;
+    results[si * width + 2] = measure([&]() {
+      for (index_t i = 0; i < h; ++i) {
+        for (index_t j = 0; j < w; ++j) {
+          dst[j * h + i] = src[i * w + j];
+        }
+      }
+    });
+    results[si * width + 3] =
+        measure([&]() { transpose_blocked(src, h, w, w, dst, h); });
+    results[si * width + 4] =
+        measure([&]() { transpose_blocked<true>(src, h, w, w, dst, h); });
+    results[si * width + 5] =
+        measure([&]() { transpose_parallel(src, h, w, w, dst, h); });
+    if (h == w) {
+      results[si * width + 6] =
+          measure([&]() { transpose_inplace(src, h, w); });
+    }
+    _mm_free(src);
+    _mm_free(dst);
+  }
+
+  std::stringstream stream;
+  stream << iterations << "_"
+         << std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+  tofile("build/results/transpose_results_" + stream.str() + ".csv", results,
+         height, width, "IDX,ROWS,COLS,SCALAR,BLOCKED,STREAM,PARALLEL,INPLACE");
+  aligned_free(results);
+}
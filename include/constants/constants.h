@@ -14,5 +14,38 @@
 #include "../types/types.h"
 
 const index_t ALIGN_BYTE_SIZE = 64;
+// budget (bytes) of generated B matrix code streamed per row tile. Half of a
+// 32 KiB L1 instruction cache keeps a k-segment resident across all row tiles
+// while leaving room for the driver kernels.
+const index_t L1I_CODE_BUDGET_BYTES = 16 * 1024;
+// budget (bytes) of a shape specialized whole GEMM kernel. It replaces the
+// driver and the B code, hence it may take the whole L1 instruction cache.
+// Larger shapes use the k-segmented kernels.
+const index_t FUSED_GEMM_CODE_BUDGET_BYTES = 32 * 1024;
+// default number of A columns to prefetch ahead in the GEMM kernels (T0 at
+// the distance, T1 at twice the distance). Column major A with a large M has
+// a stride the hardware prefetcher does not follow across pages.
+const index_t A_PREFETCH_DISTANCE = 8;
+// edge (elements) of the square tiles visited by the blocked transposes. The
+// source and destination rows of a 64x64 float tile (2 x 16 KiB) stay in L1d
+// / L2 while its 16x16 register blocks are transposed.
+const index_t TRANSPOSE_BLOCK_SIZE = 64;
+// minimum size of the memory chunks requested from the heap by the thread
+// local workspace arenas
+const index_t ARENA_CHUNK_BYTES = 4 * 1024 * 1024;
+// size of a (transparent) huge page on x86-64
+const index_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+// factor by which a Buffer grows its capacity when a resize exceeds it
+const index_t BUFFER_GROWTH_FACTOR = 2;
+// channels per block of the LAYOUT_NCHW16C tensor layout (one zmm register)
+const index_t CHANNEL_BLOCK_SIZE = 16;
+// Winograd tile positions multiplied per round of the elementwise multiply
+// (one accumulator register each). Transformed tiles are padded to a multiple
+// of it, e.g. the 36 positions of a 6x6 tile to 40.
+const index_t WINO_POSITIONS_PER_ROUND = 8;
+// budget (bytes) of the per thread buffers of the fused Winograd pipeline. A
+// block of tiles is sized so that its transformed input and output fit in
+// half of a 1 MiB L2 cache.
+const index_t WINO_BLOCK_BYTES = 512 * 1024;
 
 #endif
\ No newline at end of file
@@ -33,6 +33,9 @@ class Convolver {
   Convolver();
   virtual void run(const Tensor<T> *filter, const Tensor<T> *input,
                    Tensor<T> *output);
+  // activation layout expected by run. Inputs in other layouts are reordered
+  // once by the caller rather than accessed with strides on every layer.
+  virtual layout_t get_preferred_layout() const { return LAYOUT_NCHW; }
   index_t compute_output_width(index_t in_width, index_t filter_width);
   index_t compute_output_height(index_t in_height, index_t filter_height);
   void set_padding(std::vector<index_t> padding);
@@ -113,14 +116,16 @@ bool Convolver<T>::need_padding() {
 template <typename T>
 void Convolver<T>::pad_input(const Tensor<T> *input, Tensor<T> *padded_input) {
   const T *in_data = input->data();
-  T *padded_in_data = padded_input->mutable_data();
 
   index_t batches = input->dim(0);
   index_t channels = input->dim(1);
   index_t in_height = input->dim(2);
   index_t in_width = input->dim(3);
-  index_t in_area = in_height * in_width;
-  index_t in_batch_size = in_area * channels;
+  // the input may be a strided view
+  index_t batch_stride = input->stride(0);
+  index_t channel_stride = input->stride(1);
+  index_t row_stride = input->stride(2);
+  index_t col_stride = input->stride(3);
 
   index_t pad_top = this->__padding->at(0);
   index_t pad_bottom = this->__padding->at(1);
@@ -131,17 +136,25 @@ void Convolver<T>::pad_input(const Tensor<T> *input, Tensor<T> *padded_input) {
   index_t padded_in_area = padded_in_height * padded_in_width;
   index_t padded_in_batch_size = padded_in_area * channels;
   padded_input->resize({batches, channels, padded_in_height, padded_in_width});
+  padded_input->clear();
+  T *padded_in_data = padded_input->mutable_data();
 
   for (index_t m = 0; m < batches; ++m) {
-    const T *in_batch_ptr = in_data + m * in_batch_size;
+    const T *in_batch_ptr = in_data + m * batch_stride;
     T *pad_in_batch_ptr = padded_in_data + m * padded_in_batch_size;
     for (index_t c = 0; c < channels; ++c) {
-      const T *in_channel_ptr = in_batch_ptr + c * in_area;
+      const T *in_channel_ptr = in_batch_ptr + c * channel_stride;
       T *padded_in_channel_ptr = pad_in_batch_ptr + c * padded_in_area;
       for (index_t h = 0; h < in_height; ++h) {
-        const T *in_ptr = in_channel_ptr + h * in_width;
+        const T *in_ptr = in_channel_ptr + h * row_stride;
         T *pad_in_ptr = padded_in_channel_ptr + (h + pad_top) * padded_in_width;
-        memcpy(pad_in_ptr + pad_left, in_ptr, sizeof(T) * in_width);
+        if (col_stride == 1) {
+          memcpy(pad_in_ptr + pad_left, in_ptr, sizeof(T) * in_width);
+        } else {
+          for (index_t w = 0; w < in_width; ++w) {
+            pad_in_ptr[pad_left + w] = in_ptr[w * col_stride];
+          }
+        }
       }
     }
   }
@@ -32,6 +32,10 @@ template <typename T>
 void conv2d::DirectConvolver<T>::run(const Tensor<T> *filter,
                                      const Tensor<T> *input,
                                      Tensor<T> *output) {
+  if (input->get_layout() != this->get_preferred_layout()) {
+    throw std::invalid_argument(
+        "direct convolution requires an NCHW input, reorder the input first");
+  }
   const T *filter_data = filter->data();
   const T *input_data = input->data();
 
@@ -44,8 +48,9 @@ void conv2d::DirectConvolver<T>::run(const Tensor<T> *filter,
   const index_t channels = input->dim(1);
   index_t in_height = input->dim(2);
   index_t in_width = input->dim(3);
-  index_t batch_size = channels * in_height * in_width;
-  index_t in_area = in_height * in_width;
+  // inputs and outputs may be strided views
+  index_t in_strides[4] = {input->stride(0), input->stride(1),
+                           input->stride(2), input->stride(3)};
 
   const index_t num_filters = filter->dim(0);
   const index_t f_channels = filter->dim(1);
@@ -70,46 +75,51 @@ void conv2d::DirectConvolver<T>::run(const Tensor<T> *filter,
       this->compute_output_height(in_height, filter_height);
   const index_t output_width =
       this->compute_output_width(in_width, filter_width);
-  const index_t out_batch_size = num_filters * output_height * output_width;
-  const index_t out_area = output_height * output_width;
-  output->resize({batches, num_filters, output_height, output_width});
-  output->clear();
+  const std::vector<index_t> out_dims = {batches, num_filters, output_height,
+                                         output_width};
+  if (output->get_dims() != out_dims ||
+      output->get_layout() != LAYOUT_NCHW) {
+    output->set_layout(LAYOUT_NCHW);
+    output->resize(out_dims);
+  }
   T *output_data = output->mutable_data();
+  const index_t out_strides[4] = {output->stride(0), output->stride(1),
+                                  output->stride(2), output->stride(3)};
 
   // swap padded input and input if necessary
   if (this->need_padding()) {
-    index_t padded_height = padded_input->dim(2);
-    index_t padded_width = padded_input->dim(3);
-    in_height = padded_height;
-    in_width = padded_width;
-    batch_size = channels * in_height * in_width;
-    in_area = in_height * in_width;
+    in_height = padded_input->dim(2);
+    in_width = padded_input->dim(3);
+    for (index_t i = 0; i < 4; ++i) {
+      in_strides[i] = padded_input->stride(i);
+    }
     input_data = padded_input->data();
   }
 
   for (index_t m = 0; m < batches; ++m) {
-    const T *input_batch_ptr = input_data + m * batch_size;
-    T *output_batch_ptr = output_data + m * out_batch_size;
+    const T *input_batch_ptr = input_data + m * in_strides[0];
+    T *output_batch_ptr = output_data + m * out_strides[0];
     for (index_t n = 0; n < num_filters; ++n) {
       const T *filter_idx_ptr = filter_data + n * filter_size;
-      T *output_ptr = output_batch_ptr + n * out_area;
-      for (index_t c = 0; c < channels; ++c) {
-        const T *filter_ptr = filter_idx_ptr + c * filter_area;
-        const T *input_ch_ptr = input_batch_ptr + c * in_area;
-        for (index_t i = 0; i <= in_height - filter_height;
-             i += vertical_stride) {
-          for (index_t j = 0; j <= in_width - filter_width;
-               j += horizontal_stride) {
-            index_t out_idx =
-                (i / vertical_stride) * output_width + (j / horizontal_stride);
-            const T *input_ptr = input_ch_ptr + i * in_width + j;
+      T *output_ptr = output_batch_ptr + n * out_strides[1];
+      for (index_t i = 0; i <= in_height - filter_height;
+           i += vertical_stride) {
+        for (index_t j = 0; j <= in_width - filter_width;
+             j += horizontal_stride) {
+          T sum = 0;
+          for (index_t c = 0; c < channels; ++c) {
+            const T *filter_ptr = filter_idx_ptr + c * filter_area;
+            const T *input_ptr = input_batch_ptr + c * in_strides[1] +
+                                 i * in_strides[2] + j * in_strides[3];
             for (index_t x = 0; x < filter_height; ++x) {
               for (index_t y = 0; y < filter_width; ++y) {
-                output_ptr[out_idx] += input_ptr[x * in_width + y] *
-                                       filter_ptr[x * filter_width + y];
+                sum += input_ptr[x * in_strides[2] + y * in_strides[3]] *
+                       filter_ptr[x * filter_width + y];
               }
             }
           }
+          output_ptr[(i / vertical_stride) * out_strides[2] +
+                     (j / horizontal_stride) * out_strides[3]] = sum;
         }
       }
     }
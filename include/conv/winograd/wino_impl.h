@@ -14,6 +14,10 @@
 #include <omp.h>
 #include <stdio.h>
 
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
 #include "gemm/gemm.h"
 #include "gemm/gemm_winograd.h"
 #include "mem/allocator.h"
@@ -21,9 +25,9 @@
 #include "tensor/tensor.h"
 #include "types/types.h"
 #include "utils/utils.h"
-#include "wino_3x3.h"
 #include "wino_interface.h"
 #include "wino_multiply.h"
+#include "wino_transform.h"
 
 using namespace MARLIN;
 
@@ -33,9 +37,40 @@ class Winograd : public IWinograd<T, W, O> {
   std::shared_ptr<Buffer<T>> scratch;
   std::unique_ptr<GEMMWinograd<T>> gemm;
   gemm_library lib_switch;
+  // size of the thread team shared by all stages of run (0: OpenMP default)
+  index_t num_threads;
+  // fused pipeline and its tiles per block (0: derived from WINO_BLOCK_BYTES)
+  bool fused;
+  index_t block_tiles;
+  // settings the scratch was last reserved for
+  bool planned_fuse;
+  index_t planned_threads;
+  index_t planned_block_tiles;
+  // zero padding {top, bottom, left, right} around the input
+  std::vector<index_t> padding;
+#ifdef ENABLE_JIT
+  void run_fused(const WinoGeometry& g, const std::shared_ptr<Tensor<T>> input,
+                 T* blocks, std::shared_ptr<Tensor<T>> output,
+                 const WinoJitter<T>* jitter);
+#else
+  void run_fused(const WinoGeometry& g, const std::shared_ptr<Tensor<T>> input,
+                 T* blocks, std::shared_ptr<Tensor<T>> output,
+                 const T* transformed_filter_data);
+#endif
 
  public:
-  Winograd(gemm_library lib = LIBMARLIN);
+  // edges of the output tiles (M), filters (R) and input tiles (M + R - 1)
+  static constexpr index_t OUT_TILE = wino_output_tile(O);
+  static constexpr index_t KERNEL = wino_kernel_size(W);
+  static constexpr index_t IN_TILE = OUT_TILE + KERNEL - 1;
+  // positions per transformed tile, padded to whole multiply rounds. The
+  // transformed filter handed to the WinoJitter spans as many positions.
+  static constexpr index_t TILE_AREA = wino_tile_area(OUT_TILE, KERNEL);
+
+  // scratch_allocator selects the memory backing the transformed tensors
+  // (e.g. ARENA_ALLOCATOR for the thread local arena)
+  Winograd(gemm_library lib = LIBMARLIN,
+           allocator_t scratch_allocator = CPU_ALLOCATOR);
 #ifdef ENABLE_JIT
   void run(const std::shared_ptr<Tensor<T>> input,
            const std::shared_ptr<Tensor<T>> filter,
@@ -50,229 +85,443 @@ class Winograd : public IWinograd<T, W, O> {
     this->gemm->set_switch(lib_switch);
   }
 #endif
-  void transform_input(const T* input, const index_t batch,
-                       const index_t in_height, const index_t in_width,
-                       const index_t in_channels, const index_t tile_count,
-                       float* output);
+  // run in three steps, which lets a WinogradPlan move the first two out of
+  // the per call path. get_geometry validates the shapes and derives the
+  // padding and tile counts, reserve sizes the scratch for the geometry and
+  // the current settings and execute convolves. Without the JIT, execute
+  // transforms filter_data in to transformed_filter_data first unless
+  // filter_data is null, i.e. the filter was transformed beforehand.
+  WinoGeometry get_geometry(const std::vector<index_t>& input_dims,
+                            const std::vector<index_t>& filter_dims);
+  void reserve(const WinoGeometry& geometry);
+#ifdef ENABLE_JIT
+  void execute(const WinoGeometry& geometry,
+               const std::shared_ptr<Tensor<T>> input,
+               std::shared_ptr<Tensor<T>> output, const WinoJitter<T>* jitter);
+#else
+  void execute(const WinoGeometry& geometry,
+               const std::shared_ptr<Tensor<T>> input,
+               std::shared_ptr<Tensor<T>> output, const T* filter_data,
+               T* transformed_filter_data);
+#endif
+  void set_num_threads(index_t num_threads) {
+    this->num_threads = num_threads;
+  }
+  index_t get_num_threads() const {
+    return num_threads > 0 ? num_threads : omp_get_max_threads();
+  }
+  // The fused pipeline never materializes the transformed tensors. Every
+  // thread transforms a block of horizontally adjacent tiles in to a private
+  // buffer, multiplies it and transforms it back while the block is still in
+  // L2. It requires the LIBMARLIN (or JIT) multiply.
+  void set_fused(bool fused) { this->fused = fused; }
+  bool is_fused() const { return fused; }
+  void set_block_tiles(index_t block_tiles) {
+    this->block_tiles = block_tiles;
+  }
+  index_t get_block_tiles(index_t in_channels, index_t out_channels) const {
+    if (block_tiles > 0) return block_tiles;
+    const index_t bytes = TILE_AREA * (in_channels + out_channels) * sizeof(T);
+    return std::max<index_t>(16, WINO_BLOCK_BYTES / bytes / 16 * 16);
+  }
+  // The padding is never materialized. The tiles start pad top rows and pad
+  // left columns before the image and the input transform reads every row
+  // and column outside of it as zero, so padded ("same") convolutions cost
+  // no more than unpadded ("valid") ones.
+  void set_padding(const std::vector<index_t>& padding) {
+    if (padding.size() != 4) {
+      throw std::invalid_argument(
+          "padding requires {top, bottom, left, right}");
+    }
+    this->padding = padding;
+  }
+  // padding that keeps the spatial size of the input
+  void set_same_padding() {
+    set_padding(std::vector<index_t>(4, (KERNEL - 1) / 2));
+  }
+  const std::vector<index_t>& get_padding() const { return padding; }
+  // The stages below use orphaned OpenMP worksharing. run opens a single
+  // parallel region and every stage splits its (batch, channel) loop among
+  // that team with a static schedule. Called on their own they run on the
+  // calling thread. The input and output transforms read and write the
+  // (possibly strided) tensors directly, border tiles are handled by masked
+  // loads and stores instead of padded copies.
+  void transform_input(const std::shared_ptr<Tensor<T>> input,
+                       const WinoGeometry& geometry, T* output);
   void transform_kernel(const T* filter, const index_t num_filters,
                         const index_t channels, T* output);
-  void transform_output(const T* input, const index_t batch,
-                        const index_t out_height, index_t out_width,
-                        const index_t out_channels, const index_t tile_count,
-                        T* output);
-  void calculate_output_shape_pad_size(const std::shared_ptr<Tensor<T>> input,
-                                       const std::shared_ptr<Tensor<T>> filter,
+  void transform_output(const T* input, const WinoGeometry& geometry,
+                        std::shared_ptr<Tensor<T>> output);
+  void calculate_output_shape_pad_size(const std::vector<index_t>& input_dims,
+                                       const std::vector<index_t>& filter_dims,
                                        const index_t out_tile_height,
                                        const index_t out_tile_width,
                                        std::vector<index_t>* output_shape,
                                        std::vector<index_t>* in_pad_size,
                                        std::vector<index_t>* out_pad_size);
-  void pad_input(const std::shared_ptr<Tensor<T>> input, const index_t pad_top,
-                 const index_t pad_left,
-                 std::shared_ptr<Tensor<T>> padded_input);
-  void unpad_output(std::shared_ptr<Tensor<T>> output, const T* padded_output,
-                    const index_t padded_height, const index_t padded_width);
 };
 
 template <typename T, wino_k_t W, wino_o_t O>
-Winograd<T, W, O>::Winograd(gemm_library lib) {
-  this->scratch = std::make_shared<Buffer<T>>(GetCPUAllocator<T>());
+Winograd<T, W, O>::Winograd(gemm_library lib, allocator_t scratch_allocator) {
+  this->scratch =
+      std::make_shared<Buffer<T>>(GetAllocator<T>(scratch_allocator));
   this->gemm = std::make_unique<GEMMWinograd<T>>();
   this->lib_switch = lib;
+  this->num_threads = 0;
+  this->fused = false;
+  this->block_tiles = 0;
+  this->planned_fuse = false;
+  this->planned_threads = 1;
+  this->planned_block_tiles = 0;
+  this->padding = {0, 0, 0, 0};
 }
 
 template <typename T, wino_k_t W, wino_o_t O>
 void Winograd<T, W, O>::transform_kernel(const T* filter,
                                          const index_t num_filters,
                                          const index_t channels, T* output) {
-  if (W == WINO_K_3x3 && O == WINO_O_2x2) {
-    wino_transform_kernel_3x3_2x2(filter, num_filters, channels, output);
+  if constexpr (WinoMatrices<OUT_TILE, KERNEL>::SUPPORTED) {
+    wino_transform_kernel<OUT_TILE, KERNEL>(filter, num_filters, channels,
+                                            output);
+  } else {
+    throw std::runtime_error("unsupported winograd configuration");
   }
 }
 
 template <typename T, wino_k_t W, wino_o_t O>
-void Winograd<T, W, O>::transform_input(const T* input, const index_t batch,
-                                        const index_t in_height,
-                                        const index_t in_width,
-                                        const index_t in_channels,
-                                        const index_t tile_count,
-                                        float* output) {
-  if (W == WINO_K_3x3 && O == WINO_O_2x2) {
-    wino_transform_input_3x3_2x2(input, batch, in_height, in_width, in_channels,
-                                 tile_count, output);
+void Winograd<T, W, O>::transform_input(const std::shared_ptr<Tensor<T>> input,
+                                        const WinoGeometry& g, T* output) {
+  if constexpr (WinoMatrices<OUT_TILE, KERNEL>::SUPPORTED) {
+    wino_transform_input<OUT_TILE, KERNEL>(
+        input->data(), g.batch, g.in_channels, g.in_height, g.in_width,
+        input->stride(0), input->stride(1), input->stride(2), input->stride(3),
+        g.pad_top, g.pad_left, g.tiles_h, g.tiles_w, output);
+  } else {
+    throw std::runtime_error("unsupported winograd configuration");
   }
 }
 
 template <typename T, wino_k_t W, wino_o_t O>
-void Winograd<T, W, O>::transform_output(const T* input, const index_t batch,
-                                         const index_t out_height,
-                                         const index_t out_width,
-                                         const index_t out_channels,
-                                         const index_t tile_count, T* output) {
-  if (W == WINO_K_3x3 && O == WINO_O_2x2) {
-    wino_transform_output_3x3_2x2(input, batch, out_height, out_width,
-                                  out_channels, tile_count, output);
+void Winograd<T, W, O>::transform_output(const T* input, const WinoGeometry& g,
+                                         std::shared_ptr<Tensor<T>> output) {
+  if constexpr (WinoMatrices<OUT_TILE, KERNEL>::SUPPORTED) {
+    wino_transform_output<OUT_TILE, KERNEL>(
+        input, g.batch, g.out_channels, g.tiles_h, g.tiles_w,
+        output->mutable_data(), g.out_height, g.out_width, output->stride(0),
+        output->stride(1), output->stride(2), output->stride(3));
+  } else {
+    throw std::runtime_error("unsupported winograd configuration");
   }
 }
 
 template <typename T, wino_k_t W, wino_o_t O>
-#ifdef ENABLE_JIT
-void Winograd<T, W, O>::run(const std::shared_ptr<Tensor<T>> input,
-                            const std::shared_ptr<Tensor<T>> filter,
-                            std::shared_ptr<Tensor<T>> output,
-                            std::shared_ptr<WinoJitter<T>> jitter) {
-#else
-void Winograd<T, W, O>::run(const std::shared_ptr<Tensor<T>> input,
-                            const std::shared_ptr<Tensor<T>> filter,
-                            std::shared_ptr<Tensor<T>> output) {
-
-#endif
-  const index_t batch = input->dim(0);
-  const index_t in_channels = input->dim(1);
-  const index_t in_height = input->dim(2);
-  const index_t in_width = input->dim(3);
-
-  const index_t out_channels = filter->dim(0);
+WinoGeometry Winograd<T, W, O>::get_geometry(
+    const std::vector<index_t>& input_dims,
+    const std::vector<index_t>& filter_dims) {
+  if constexpr (!WinoMatrices<OUT_TILE, KERNEL>::SUPPORTED) {
+    throw std::runtime_error("unsupported winograd configuration");
+  }
+  if (input_dims.size() != 4 || filter_dims.size() != 4) {
+    throw std::invalid_argument("winograd convolution expects 4D tensors");
+  }
+  if (filter_dims[2] != KERNEL || filter_dims[3] != KERNEL) {
+    throw std::invalid_argument("expected a " + std::to_string(KERNEL) + "x" +
+                                std::to_string(KERNEL) + " filter");
+  }
+  if (input_dims[1] != filter_dims[1]) {
+    throw std::invalid_argument("input and filter channels do not match");
+  }
 
   std::vector<index_t> output_shape;
   std::vector<index_t> in_pad_size;
   std::vector<index_t> out_pad_size;
-
-  index_t out_tile_size;
-  switch (O) {
-    case WINO_O_2x2:
-      out_tile_size = 2;
-      break;
-    default:
-      out_tile_size = 2;
-  }
-  index_t in_tile_adjustment;
-  switch (W) {
-    case WINO_K_3x3:
-      in_tile_adjustment = 2;
-      break;
-    default:
-      throw std::runtime_error("impossible execution path");
-  }
-
-  calculate_output_shape_pad_size(input, filter, out_tile_size, out_tile_size,
+  calculate_output_shape_pad_size(input_dims, filter_dims, OUT_TILE, OUT_TILE,
                                   &output_shape, &in_pad_size, &out_pad_size);
 
-  // default padding is given below. Winograd padding
-  // is added to the right and on the bottom
-  const index_t out_height = output_shape[2];
-  const index_t out_width = output_shape[3];
-  const index_t padded_in_height = in_height + in_pad_size[0] + in_pad_size[1];
-  const index_t padded_in_width = in_width + in_pad_size[2] + in_pad_size[3];
-  const index_t padded_out_height =
-      out_height + out_pad_size[0] + out_pad_size[1];
-  const index_t padded_out_width =
-      out_width + out_pad_size[2] + out_pad_size[3];
-  const index_t pad_top = in_pad_size.data()[0];
-  const index_t pad_left = in_pad_size.data()[2];
-
-  const index_t tile_height_count = padded_out_height / out_tile_size;
-  const index_t tile_width_count = padded_out_width / out_tile_size;
-  const index_t tile_count = tile_height_count * tile_width_count;
-  const index_t in_tile_area = (out_tile_size + in_tile_adjustment) *
-                               (out_tile_size + in_tile_adjustment);
+  // the tiles cover the output rounded up to whole tiles. their input rows
+  // and columns past the image are read as zeros.
+  WinoGeometry g;
+  g.batch = input_dims[0];
+  g.in_channels = input_dims[1];
+  g.in_height = input_dims[2];
+  g.in_width = input_dims[3];
+  g.out_channels = filter_dims[0];
+  g.out_height = output_shape[2];
+  g.out_width = output_shape[3];
+  g.pad_top = in_pad_size[0];
+  g.pad_left = in_pad_size[2];
+  g.tiles_h = (g.out_height + out_pad_size[0] + out_pad_size[1]) / OUT_TILE;
+  g.tiles_w = (g.out_width + out_pad_size[2] + out_pad_size[3]) / OUT_TILE;
+  g.tile_count = g.tiles_h * g.tiles_w;
+  return g;
+}
 
-  const index_t padded_in_size =
-      batch * in_channels * padded_in_height * padded_in_width;
-  const index_t padded_out_size =
-      batch * out_channels * padded_out_height * padded_out_width;
+template <typename T, wino_k_t W, wino_o_t O>
+void Winograd<T, W, O>::reserve(const WinoGeometry& g) {
+#ifdef ENABLE_JIT
+  planned_fuse = fused;
+#else
+  planned_fuse = fused && lib_switch == LIBMARLIN;
+  if (lib_switch == JITMKL) {
+    this->gemm->init_jit_library(g.out_channels, g.tile_count, g.in_channels);
+  }
+#endif
+  planned_threads = get_num_threads();
+  planned_block_tiles = get_block_tiles(g.in_channels, g.out_channels);
 
+  // the fused pipeline replaces the transformed tensors (and the pack area)
+  // by one block buffer per thread
+  const index_t block_size =
+      TILE_AREA * (g.in_channels + g.out_channels) * planned_block_tiles;
   const index_t transformed_in_size =
-      batch * in_tile_area * in_channels * tile_count;
+      planned_fuse ? planned_threads * block_size
+                   : g.batch * TILE_AREA * g.in_channels * g.tile_count;
   const index_t transformed_out_size =
-      batch * in_tile_area * out_channels * tile_count;
+      planned_fuse ? 0 : g.batch * TILE_AREA * g.out_channels * g.tile_count;
   const index_t transformed_filter_size =
-      in_tile_area * out_channels * in_channels;
+      TILE_AREA * g.out_channels * g.in_channels;
   const index_t gemm_pack_size =
-      transformed_in_size + transformed_filter_size + transformed_filter_size;
+      planned_fuse ? 0
+                   : transformed_in_size + transformed_filter_size +
+                         transformed_filter_size;
 
-  this->scratch->resize(padded_in_size + padded_out_size + transformed_in_size +
-                        transformed_out_size + gemm_pack_size);
-
-  std::shared_ptr<Tensor<T>> padded_in_tensor =
-      std::make_shared<Tensor<T>>(this->scratch);
-  padded_in_tensor->resize(
-      {batch, in_channels, padded_in_height, padded_in_width});
-
-  pad_input(input, pad_top, pad_left, padded_in_tensor);
+  this->scratch->resize((transformed_in_size + transformed_out_size +
+                         gemm_pack_size) *
+                        sizeof(T));
+}
 
-  T* pad_data = padded_in_tensor->mutable_data();
-  T* pad_out_data = pad_data + padded_in_size;
-  T* transformed_in_data = pad_out_data + padded_out_size;
-  T* transformed_out_data = transformed_in_data + transformed_in_size;
+template <typename T, wino_k_t W, wino_o_t O>
+#ifdef ENABLE_JIT
+void Winograd<T, W, O>::run(const std::shared_ptr<Tensor<T>> input,
+                            const std::shared_ptr<Tensor<T>> filter,
+                            std::shared_ptr<Tensor<T>> output,
+                            std::shared_ptr<WinoJitter<T>> jitter) {
+#else
+void Winograd<T, W, O>::run(const std::shared_ptr<Tensor<T>> input,
+                            const std::shared_ptr<Tensor<T>> filter,
+                            std::shared_ptr<Tensor<T>> output) {
 
-#ifndef ENABLE_JIT
+#endif
+  const WinoGeometry g = get_geometry(input->get_dims(), filter->get_dims());
+  reserve(g);
+#ifdef ENABLE_JIT
+  execute(g, input, output, jitter.get());
+#else
   std::shared_ptr<Tensor<T>> transformed_filter = std::make_shared<Tensor<T>>();
-  transformed_filter->resize({out_channels, in_channels, in_tile_area});
-  T* transformed_filter_data = transformed_filter->mutable_data();
-  const T* filter_data = filter->data();
-
-  this->transform_kernel(filter_data, out_channels, in_channels,
-                         transformed_filter_data);
+  transformed_filter->resize({g.out_channels, g.in_channels, TILE_AREA});
+  execute(g, input, output, filter->data(),
+          transformed_filter->mutable_data());
 #endif
+}
 
-  this->transform_input(pad_data, batch, padded_in_height, padded_in_width,
-                        in_channels, tile_count, transformed_in_data);
+template <typename T, wino_k_t W, wino_o_t O>
+#ifdef ENABLE_JIT
+void Winograd<T, W, O>::execute(const WinoGeometry& g,
+                                const std::shared_ptr<Tensor<T>> input,
+                                std::shared_ptr<Tensor<T>> output,
+                                const WinoJitter<T>* jitter) {
+#else
+void Winograd<T, W, O>::execute(const WinoGeometry& g,
+                                const std::shared_ptr<Tensor<T>> input,
+                                std::shared_ptr<Tensor<T>> output,
+                                const T* filter_data,
+                                T* transformed_filter_data) {
+#endif
+  if (input->get_layout() != this->get_preferred_layout()) {
+    throw std::invalid_argument(
+        "winograd convolution requires an NCHW input, reorder the input "
+        "first");
+  }
+  const index_t in_tile_area = TILE_AREA;
+  const index_t batch = g.batch;
+  const index_t in_channels = g.in_channels;
+  const index_t out_channels = g.out_channels;
+  const index_t tile_count = g.tile_count;
 
-  // perform elementwise multiplication
   const index_t transform_in_size_per_batch =
       in_tile_area * in_channels * tile_count;
   const index_t transform_out_size_per_batch =
       in_tile_area * out_channels * tile_count;
+  const index_t transformed_in_size =
+      planned_fuse ? planned_threads * in_tile_area *
+                         (in_channels + out_channels) * planned_block_tiles
+                   : batch * transform_in_size_per_batch;
 
-#ifndef ENABLE_JIT
-  if (lib_switch == JITMKL) {
-    this->gemm->init_jit_library(out_channels, tile_count, in_channels);
+  // the transformed input (or the block buffers) heads the scratch
+  T* transformed_in_data = this->scratch->mutable_data();
+  T* transformed_out_data = transformed_in_data + transformed_in_size;
+
+  // views of the expected shape (e.g. a channel group of a larger tensor)
+  // are written in place
+  const std::vector<index_t> out_dims = {batch, out_channels, g.out_height,
+                                         g.out_width};
+  if (output->get_dims() != out_dims ||
+      output->get_layout() != LAYOUT_NCHW) {
+    output->set_layout(LAYOUT_NCHW);
+    output->resize(out_dims);
   }
-#endif
 
-  for (index_t b = 0; b < batch; ++b) {
-    T* transform_in = transformed_in_data + b * transform_in_size_per_batch;
-    T* transform_out = transformed_out_data + b * transform_out_size_per_batch;
+  // all stages share one thread team. exceptions may not leave the parallel
+  // region and are rethrown once it is joined.
+  std::exception_ptr error;
+#pragma omp parallel num_threads(planned_threads)
+  {
 #ifndef ENABLE_JIT
-    if (lib_switch == LIBMARLIN) {
-      compute(transformed_filter_data, transform_in, in_tile_area, out_channels,
-              tile_count, in_channels, transform_out);
-    } else {
-      gemm->compute(transformed_filter_data, transform_in, in_tile_area,
-                    out_channels, tile_count, in_channels, transform_out);
+    if (filter_data != nullptr) {
+      this->transform_kernel(filter_data, out_channels, in_channels,
+                             transformed_filter_data);
     }
+#endif
+    if (planned_fuse) {
+#ifdef ENABLE_JIT
+      run_fused(g, input, transformed_in_data, output, jitter);
 #else
-    compute(transform_in, in_tile_area, out_channels, tile_count, in_channels,
-            transform_out, jitter);
-
+      run_fused(g, input, transformed_in_data, output,
+                transformed_filter_data);
 #endif
+    } else {
+      this->transform_input(input, g, transformed_in_data);
+
+      // perform elementwise multiplication
+      for (index_t b = 0; b < batch; ++b) {
+        T* transform_in =
+            transformed_in_data + b * transform_in_size_per_batch;
+        T* transform_out =
+            transformed_out_data + b * transform_out_size_per_batch;
+#ifndef ENABLE_JIT
+        if (lib_switch == LIBMARLIN) {
+          compute(transformed_filter_data, transform_in, in_tile_area,
+                  out_channels, tile_count, in_channels, transform_out);
+        } else {
+#pragma omp single
+          try {
+            gemm->compute(transformed_filter_data, transform_in,
+                          in_tile_area, out_channels, tile_count, in_channels,
+                          transform_out);
+          } catch (...) {
+            error = std::current_exception();
+          }
+        }
+#else
+        compute(transform_in, in_tile_area, out_channels, tile_count,
+                in_channels, transform_out, jitter);
+#endif
+      }
+      transform_output(transformed_out_data, g, output);
+    }
   }
-  transform_output(transformed_out_data, batch, padded_out_height,
-                   padded_out_width, out_channels, tile_count, pad_out_data);
+  if (error) std::rethrow_exception(error);
+}
 
-  output->resize({batch, out_channels, out_height, out_width});
-  unpad_output(output, pad_out_data, padded_out_height, padded_out_width);
-  return;
+template <typename T, wino_k_t W, wino_o_t O>
+#ifdef ENABLE_JIT
+void Winograd<T, W, O>::run_fused(const WinoGeometry& g,
+                                  const std::shared_ptr<Tensor<T>> input,
+                                  T* blocks, std::shared_ptr<Tensor<T>> output,
+                                  const WinoJitter<T>* jitter) {
+#else
+void Winograd<T, W, O>::run_fused(const WinoGeometry& g,
+                                  const std::shared_ptr<Tensor<T>> input,
+                                  T* blocks, std::shared_ptr<Tensor<T>> output,
+                                  const T* transformed_filter_data) {
+#endif
+  if constexpr (WinoMatrices<OUT_TILE, KERNEL>::SUPPORTED) {
+    constexpr index_t A = IN_TILE;
+    const index_t in_channels = g.in_channels;
+    const index_t out_channels = g.out_channels;
+    const index_t block_tiles = planned_block_tiles;
+    const index_t blocks_w = (g.tiles_w + block_tiles - 1) / block_tiles;
+
+    const T* in_data = input->data();
+    const index_t in_batch_stride = input->stride(0);
+    const index_t in_channel_stride = input->stride(1);
+    const index_t in_row_stride = input->stride(2);
+    const index_t in_col_stride = input->stride(3);
+    T* out_data = output->mutable_data();
+    const index_t out_batch_stride = output->stride(0);
+    const index_t out_channel_stride = output->stride(1);
+    const index_t out_row_stride = output->stride(2);
+    const index_t out_col_stride = output->stride(3);
+
+    // block buffers [position][channel][tile] of this thread
+    T* block_in = blocks + omp_get_thread_num() * TILE_AREA *
+                               (in_channels + out_channels) * block_tiles;
+    T* block_out = block_in + TILE_AREA * in_channels * block_tiles;
+
+#pragma omp for collapse(3) schedule(static)
+    for (index_t n = 0; n < g.batch; ++n) {
+      for (index_t th = 0; th < g.tiles_h; ++th) {
+        for (index_t bw = 0; bw < blocks_w; ++bw) {
+          const index_t tw = bw * block_tiles;
+          const index_t count = std::min(block_tiles, g.tiles_w - tw);
+          const index_t in_stride = in_channels * count;
+          const index_t out_stride = out_channels * count;
+          const int64_t y = static_cast<int64_t>(th * OUT_TILE) - g.pad_top;
+
+          // transform the block of every input channel
+          for (index_t c = 0; c < in_channels; ++c) {
+            const T* image =
+                in_data + n * in_batch_stride + c * in_channel_stride;
+            for (index_t t = 0; t < count; t += 16) {
+              const int64_t x =
+                  static_cast<int64_t>((tw + t) * OUT_TILE) - g.pad_left;
+              wino_input_tiles<OUT_TILE, KERNEL>(
+                  image, g.in_height, g.in_width, in_row_stride,
+                  in_col_stride, y, x, std::min<index_t>(count - t, 16),
+                  block_in + c * count + t, in_stride);
+            }
+          }
+          // padding positions are multiplied but never read back
+          memset(block_in + A * A * in_stride, 0,
+                 sizeof(T) * (TILE_AREA - A * A) * in_stride);
+
+          // elementwise multiplication of the block
+          for (index_t m = 0; m < out_channels; ++m) {
+            for (index_t t = 0; t < count; t += 16) {
+#ifdef ENABLE_JIT
+              compute_tiles(block_in, TILE_AREA, out_channels, count,
+                            in_channels, block_out, jitter, m, t);
+#else
+              compute_tiles(transformed_filter_data, block_in, TILE_AREA,
+                            out_channels, count, in_channels, block_out, m, t);
+#endif
+            }
+          }
+
+          // inverse transform of the block straight in to the output
+          for (index_t m = 0; m < out_channels; ++m) {
+            T* image = out_data + n * out_batch_stride + m * out_channel_stride;
+            for (index_t t = 0; t < count; t += 16) {
+              wino_output_tiles<OUT_TILE, KERNEL>(
+                  block_out + m * count + t, out_stride,
+                  std::min<index_t>(count - t, 16), image, g.out_height,
+                  g.out_width, out_row_stride, out_col_stride,
+                  th * OUT_TILE, (tw + t) * OUT_TILE);
+            }
+          }
+        }
+      }
+    }
+  }
 }
 
 template <typename T, wino_k_t W, wino_o_t O>
 void Winograd<T, W, O>::calculate_output_shape_pad_size(
-    const std::shared_ptr<Tensor<T>> input,
-    const std::shared_ptr<Tensor<T>> filter, const index_t out_tile_height,
+    const std::vector<index_t>& input_dims,
+    const std::vector<index_t>& filter_dims, const index_t out_tile_height,
     const index_t out_tile_width, std::vector<index_t>* output_shape,
     std::vector<index_t>* in_pad_size, std::vector<index_t>* out_pad_size) {
-  const index_t batches = input->dim(0);
-  const index_t output_channels = filter->dim(0);
-  const index_t in_height = input->dim(2);
-  const index_t in_width = input->dim(3);
+  const index_t batches = input_dims[0];
+  const index_t output_channels = filter_dims[0];
+  const index_t in_height = input_dims[2];
+  const index_t in_width = input_dims[3];
 
   // winograd supports only stride of 1
   const index_t stride_h = 1;
   const index_t stride_w = 1;
 
-  const index_t kernel_height = filter->dim(2);
-  const index_t kernel_width = filter->dim(3);
+  const index_t kernel_height = filter_dims[2];
+  const index_t kernel_width = filter_dims[3];
 
   index_t output_height = 0;
   index_t output_width = 0;
@@ -281,13 +530,20 @@ void Winograd<T, W, O>::calculate_output_shape_pad_size(
   out_pad_size->resize(4);
   output_shape->resize(4);
 
-  output_height = (in_height - kernel_height) / stride_h + 1;
-  output_width = (in_width - kernel_width) / stride_w + 1;
+  // user padding {top, bottom, left, right} widens the input on every side
+  const index_t pad_top = padding[0];
+  const index_t pad_bottom = padding[1];
+  const index_t pad_left = padding[2];
+  const index_t pad_right = padding[3];
+  if (in_height + pad_top + pad_bottom < kernel_height ||
+      in_width + pad_left + pad_right < kernel_width) {
+    throw std::invalid_argument("padded input is smaller than the filter");
+  }
 
-  const index_t in_height_pad = std::max<index_t>(
-      0, (output_height - 1) * stride_h + kernel_height - in_height);
-  const index_t in_width_pad = std::max<index_t>(
-      0, (output_width - 1) * stride_w + kernel_width - in_width);
+  output_height =
+      (in_height + pad_top + pad_bottom - kernel_height) / stride_h + 1;
+  output_width =
+      (in_width + pad_left + pad_right - kernel_width) / stride_w + 1;
 
   output_shape->data()[0] = batches;
   output_shape->data()[1] = output_channels;
@@ -299,17 +555,17 @@ void Winograd<T, W, O>::calculate_output_shape_pad_size(
   const index_t padded_out_width =
       RoundUp<index_t>(output_width, out_tile_width);
   const index_t padded_in_height =
-      std::max(in_height + in_pad_size->data()[0],
+      std::max(in_height + pad_top + pad_bottom,
                (padded_out_height - 1) * stride_h + kernel_height);
   const index_t padded_in_width =
-      std::max(in_width + in_pad_size->data()[1],
+      std::max(in_width + pad_left + pad_right,
                (padded_out_width - 1) * stride_w + kernel_width);
 
-  in_pad_size->data()[0] = in_height_pad >> 1;
-  in_pad_size->data()[1] =
-      padded_in_height - in_height - in_pad_size->data()[0];
-  in_pad_size->data()[2] = in_width_pad >> 1;
-  in_pad_size->data()[3] = padded_in_width - in_width - in_pad_size->data()[2];
+  // the bottom and right padding include the rounding to whole tiles
+  in_pad_size->data()[0] = pad_top;
+  in_pad_size->data()[1] = padded_in_height - in_height - pad_top;
+  in_pad_size->data()[2] = pad_left;
+  in_pad_size->data()[3] = padded_in_width - in_width - pad_left;
 
   out_pad_size->data()[0] = 0;
   out_pad_size->data()[1] = static_cast<int>(padded_out_height - output_height);
@@ -317,77 +573,4 @@ void Winograd<T, W, O>::calculate_output_shape_pad_size(
   out_pad_size->data()[3] = static_cast<int>(padded_out_width - output_width);
 }
 
-template <typename T, wino_k_t W, wino_o_t O>
-void Winograd<T, W, O>::pad_input(const std::shared_ptr<Tensor<T>> input,
-                                  const index_t pad_top, const index_t pad_left,
-                                  std::shared_ptr<Tensor<T>> padded_input) {
-  const index_t batch = input->dim(0);
-  const index_t channels = input->dim(1);
-  const index_t padded_input_height = padded_input->dim(2);
-  const index_t padded_input_width = padded_input->dim(3);
-  const index_t input_height = input->dim(2);
-  const index_t input_width = input->dim(3);
-
-  const index_t img_size = input_height * input_width;
-  const index_t padded_img_size = padded_input_height * padded_input_width;
-
-  const index_t pad_bottom = padded_input_height - input_height - pad_top;
-  const index_t pad_right = padded_input_width - input_width - pad_left;
-
-  T* pad_data = padded_input->mutable_data();
-  const T* in_data = input->data();
-
-  for (index_t b = 0; b < batch; ++b) {
-    for (index_t c = 0; c < channels; ++c) {
-      const index_t bc = b * channels + c;
-      const float* in_base = in_data + bc * img_size;
-      float* padded_in_base = pad_data + bc * padded_img_size;
-
-      memset(padded_in_base, 0, sizeof(float) * pad_top * padded_input_width);
-      padded_in_base += pad_top * padded_input_width;
-      for (index_t h = 0; h < input_height; ++h) {
-        memset(padded_in_base, 0, sizeof(float) * pad_left);
-        memcpy(padded_in_base + pad_left, in_base, sizeof(float) * input_width);
-        memset(padded_in_base + pad_left + input_width, 0,
-               sizeof(float) * pad_right);
-        in_base += input_width;
-        padded_in_base += padded_input_width;
-      }
-      memset(padded_in_base, 0,
-             sizeof(float) * pad_bottom * padded_input_width);
-    }
-  }
-}
-
-template <typename T, wino_k_t W, wino_o_t O>
-void Winograd<T, W, O>::unpad_output(std::shared_ptr<Tensor<T>> output,
-                                     const T* padded_output,
-                                     const index_t padded_height,
-                                     const index_t padded_width) {
-  const index_t batch = output->dim(0);
-  const index_t channels = output->dim(1);
-  const index_t height = output->dim(2);
-  const index_t width = output->dim(3);
-
-  const T* padded_out_data = padded_output;
-  T* out_data = output->mutable_data();
-
-  const index_t img_size = height * width;
-  const index_t padded_img_size = padded_height * padded_width;
-
-  for (index_t b = 0; b < batch; ++b) {
-    for (index_t c = 0; c < channels; ++c) {
-      const index_t bc = (b * channels + c);
-      T* out_base = out_data + bc * img_size;
-      const T* padded_out_base = padded_out_data + bc * padded_img_size;
-
-      for (index_t h = 0; h < height; ++h) {
-        memcpy(out_base, padded_out_base, sizeof(T) * width);
-        out_base += width;
-        padded_out_base += padded_width;
-      }  // h
-    }    // c
-  }      // b
-}
-
 #endif
\ No newline at end of file
@@ -11,23 +11,42 @@
 #ifndef __WINO_INTERFACE_H__
 #define __WINO_INTERFACE_H__
 
+#include <memory>
+
+#include "../../tensor/tensor.h"
 #include "../../types/types.h"
 
+// shapes and tile counts of a Winograd convolution. The tiles cover the
+// output and start pad_top rows and pad_left columns before the input, the
+// input rows and columns outside of the image read as zero.
+struct WinoGeometry {
+  index_t batch;
+  index_t in_channels;
+  index_t in_height;
+  index_t in_width;
+  index_t out_channels;
+  index_t out_height;
+  index_t out_width;
+  index_t pad_top;
+  index_t pad_left;
+  index_t tiles_h;
+  index_t tiles_w;
+  index_t tile_count;
+};
+
 template <typename T, wino_k_t W, wino_o_t O>
 class IWinograd {
  private:
  public:
-  virtual void transform_input(const float* input, const index_t batch,
-                               const index_t in_height, const index_t in_width,
-                               const index_t in_channels,
-                               const index_t tile_count, float* output) = 0;
+  virtual void transform_input(const std::shared_ptr<Tensor<T>> input,
+                               const WinoGeometry& geometry, T* output) = 0;
   virtual void transform_kernel(const T* filter, index_t num_filters,
                                 index_t channels, T* output) = 0;
-  virtual void transform_output(const T* input, index_t batch,
-                                index_t out_height, index_t out_width,
-                                index_t out_channels, index_t tile_count,
-                                T* output) = 0;
+  virtual void transform_output(const T* input, const WinoGeometry& geometry,
+                                std::shared_ptr<Tensor<T>> output) = 0;
   virtual void perform_gemm();
+  // activation layout expected by the transforms
+  virtual layout_t get_preferred_layout() const { return LAYOUT_NCHW; }
 };
 
 template <typename T, wino_k_t W, wino_o_t O>
@@ -16,6 +16,7 @@
 #include "asm_wino.h"
 #include "jit/wino_jitter.h"
 #include "types/types.h"
+#include "utils/utils.h"
 
 namespace MARLIN {
 // Performs Winograd elementwise multiplication
@@ -30,12 +31,118 @@ namespace MARLIN {
 // tile count              - numer of tiles in input image
 // in channels             - number of input channels
 // transform out           - transformed winograd output
+//
+// compute_tiles handles the 16 tiles starting at tile for filter m on the
+// calling thread. compute shares all (filter, 16 tiles) pairs among the
+// threads of the enclosing parallel region.
+template <typename T>
+#ifdef ENABLE_JIT
+FORCE_INLINE inline void compute_tiles(const T* transform_in,
+                                       const index_t in_tile_area,
+                                       const index_t out_channels,
+                                       const index_t tile_count,
+                                       const index_t in_channels,
+                                       T* transform_out,
+                                       const WinoJitter<T>* jitter,
+                                       const index_t m, const index_t tile) {
+#else
+FORCE_INLINE inline void compute_tiles(const T* transformed_filter_data,
+                                       const T* transform_in,
+                                       const index_t in_tile_area,
+                                       const index_t out_channels,
+                                       const index_t tile_count,
+                                       const index_t in_channels,
+                                       T* transform_out, const index_t m,
+                                       const index_t tile) {
+#endif
+  const uint16_t mask =
+      tile + 16 <= tile_count ? 0xffff : ~(0xffff << (tile_count - tile));
+
+  for (index_t tidx = 0; tidx < in_tile_area; tidx += 8) {
+    const T* a_ptr = transform_in + tile + (tidx * tile_count) * in_channels;
+    const index_t a_stride = tile_count * in_channels;
+
+    const index_t c_stride = tile_count * out_channels;
+    T* c_ptr = transform_out + m * tile_count + tile + tidx * c_stride;
+
+#ifndef ENABLE_JIT
+    const index_t b_stride = in_channels * out_channels;
+    const T* b_ptr =
+        transformed_filter_data + tidx * b_stride + m * in_channels;
+
+    __m512 c0 = _mm512_setzero_ps();
+    __m512 c1 = _mm512_setzero_ps();
+    __m512 c2 = _mm512_setzero_ps();
+    __m512 c3 = _mm512_setzero_ps();
+    __m512 c4 = _mm512_setzero_ps();
+    __m512 c5 = _mm512_setzero_ps();
+    __m512 c6 = _mm512_setzero_ps();
+    __m512 c7 = _mm512_setzero_ps();
+
+    for (index_t c = 0; c < in_channels; ++c) {
+      const T* a_ptr_ = a_ptr + tile_count * c;
+      const T* b_ptr_ = b_ptr + c;
+
+      __m512 a0 = _mm512_maskz_loadu_ps(mask, a_ptr_);
+      __m512 a1 = _mm512_maskz_loadu_ps(mask, a_ptr_ + a_stride);
+      __m512 a2 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 2 * a_stride);
+      __m512 a3 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 3 * a_stride);
+      __m512 a4 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 4 * a_stride);
+      __m512 a5 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 5 * a_stride);
+      __m512 a6 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 6 * a_stride);
+      __m512 a7 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 7 * a_stride);
+
+      __m128 b_reg;
+      b_reg = _mm_set1_ps(*b_ptr_);
+      __m512 b0 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + b_stride));
+      __m512 b1 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + 2 * b_stride));
+      __m512 b2 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + 3 * b_stride));
+      __m512 b3 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + 4 * b_stride));
+      __m512 b4 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + 5 * b_stride));
+      __m512 b5 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + 6 * b_stride));
+      __m512 b6 = _mm512_broadcastss_ps(b_reg);
+      b_reg = _mm_set1_ps(*(b_ptr_ + 7 * b_stride));
+      __m512 b7 = _mm512_broadcastss_ps(b_reg);
+
+      c0 = _mm512_fmadd_ps(a0, b0, c0);
+      c1 = _mm512_fmadd_ps(a1, b1, c1);
+      c2 = _mm512_fmadd_ps(a2, b2, c2);
+      c3 = _mm512_fmadd_ps(a3, b3, c3);
+      c4 = _mm512_fmadd_ps(a4, b4, c4);
+      c5 = _mm512_fmadd_ps(a5, b5, c5);
+      c6 = _mm512_fmadd_ps(a6, b6, c6);
+      c7 = _mm512_fmadd_ps(a7, b7, c7);
+    }
+    _mm512_mask_storeu_ps(c_ptr, mask, c0);
+    _mm512_mask_storeu_ps(c_ptr + c_stride, mask, c1);
+    _mm512_mask_storeu_ps(c_ptr + 2 * c_stride, mask, c2);
+    _mm512_mask_storeu_ps(c_ptr + 3 * c_stride, mask, c3);
+    _mm512_mask_storeu_ps(c_ptr + 4 * c_stride, mask, c4);
+    _mm512_mask_storeu_ps(c_ptr + 5 * c_stride, mask, c5);
+    _mm512_mask_storeu_ps(c_ptr + 6 * c_stride, mask, c6);
+    _mm512_mask_storeu_ps(c_ptr + 7 * c_stride, mask, c7);
+#else
+    const index_t idx =
+        (in_tile_area / 8) * in_channels * m + (tidx / 8) * in_channels;
+    asm_wino_multiply(a_stride, c_stride, tile_count, in_channels, mask, a_ptr,
+                      c_ptr, jitter->get_p_addr(), jitter->get_offset_data(),
+                      idx);
+#endif
+  }
+}
+
 template <typename T>
 #ifdef ENABLE_JIT
 void compute(const T* transform_in, const index_t in_tile_area,
              const index_t out_channels, const index_t tile_count,
              const index_t in_channels, T* transform_out,
-             std::shared_ptr<WinoJitter<T>> jitter) {
+             const WinoJitter<T>* jitter) {
 #else
 void compute(const T* transformed_filter_data, const T* transform_in,
              const index_t in_tile_area, const index_t out_channels,
@@ -43,90 +150,17 @@ void compute(const T* transformed_filter_data, const T* transform_in,
              T* transform_out) {
 
 #endif
-#pragma omp parallel for collapse(2)
+#pragma omp for collapse(2) schedule(static)
   for (index_t m = 0; m < out_channels; ++m) {
     for (index_t tile = 0; tile < tile_count; tile += 16) {
-      const uint16_t mask =
-          tile + 16 <= tile_count ? 0xffff : ~(0xffff << (tile_count - tile));
-
-      for (index_t tidx = 0; tidx < in_tile_area; tidx += 8) {
-        const T* a_ptr =
-            transform_in + tile + (tidx * tile_count) * in_channels;
-        const index_t a_stride = tile_count * in_channels;
-
-        const index_t c_stride = tile_count * out_channels;
-        T* c_ptr = transform_out + m * tile_count + tile + tidx * c_stride;
-
-#ifndef ENABLE_JIT
-        const index_t b_stride = in_channels * out_channels;
-        const T* b_ptr =
-            transformed_filter_data + tidx * b_stride + m * in_channels;
-
-        __m512 c0 = _mm512_setzero_ps();
-        __m512 c1 = _mm512_setzero_ps();
-        __m512 c2 = _mm512_setzero_ps();
-        __m512 c3 = _mm512_setzero_ps();
-        __m512 c4 = _mm512_setzero_ps();
-        __m512 c5 = _mm512_setzero_ps();
-        __m512 c6 = _mm512_setzero_ps();
-        __m512 c7 = _mm512_setzero_ps();
-
-        for (index_t c = 0; c < in_channels; ++c) {
-          const T* a_ptr_ = a_ptr + tile_count * c;
-          const T* b_ptr_ = b_ptr + c;
-
-          __m512 a0 = _mm512_maskz_loadu_ps(mask, a_ptr_);
-          __m512 a1 = _mm512_maskz_loadu_ps(mask, a_ptr_ + a_stride);
-          __m512 a2 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 2 * a_stride);
-          __m512 a3 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 3 * a_stride);
-          __m512 a4 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 4 * a_stride);
-          __m512 a5 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 5 * a_stride);
-          __m512 a6 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 6 * a_stride);
-          __m512 a7 = _mm512_maskz_loadu_ps(mask, a_ptr_ + 7 * a_stride);
-
-          __m128 b_reg;
-          b_reg = _mm_set1_ps(*b_ptr_);
-          __m512 b0 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + b_stride));
-          __m512 b1 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + 2 * b_stride));
-          __m512 b2 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + 3 * b_stride));
-          __m512 b3 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + 4 * b_stride));
-          __m512 b4 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + 5 * b_stride));
-          __m512 b5 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + 6 * b_stride));
-          __m512 b6 = _mm512_broadcastss_ps(b_reg);
-          b_reg = _mm_set1_ps(*(b_ptr_ + 7 * b_stride));
-          __m512 b7 = _mm512_broadcastss_ps(b_reg);
-
-          c0 = _mm512_fmadd_ps(a0, b0, c0);
-          c1 = _mm512_fmadd_ps(a1, b1, c1);
-          c2 = _mm512_fmadd_ps(a2, b2, c2);
-          c3 = _mm512_fmadd_ps(a3, b3, c3);
-          c4 = _mm512_fmadd_ps(a4, b4, c4);
-          c5 = _mm512_fmadd_ps(a5, b5, c5);
-          c6 = _mm512_fmadd_ps(a6, b6, c6);
-          c7 = _mm512_fmadd_ps(a7, b7, c7);
-        }
-        _mm512_mask_storeu_ps(c_ptr, mask, c0);
-        _mm512_mask_storeu_ps(c_ptr + c_stride, mask, c1);
-        _mm512_mask_storeu_ps(c_ptr + 2 * c_stride, mask, c2);
-        _mm512_mask_storeu_ps(c_ptr + 3 * c_stride, mask, c3);
-        _mm512_mask_storeu_ps(c_ptr + 4 * c_stride, mask, c4);
-        _mm512_mask_storeu_ps(c_ptr + 5 * c_stride, mask, c5);
-        _mm512_mask_storeu_ps(c_ptr + 6 * c_stride, mask, c6);
-        _mm512_mask_storeu_ps(c_ptr + 7 * c_stride, mask, c7);
+#ifdef ENABLE_JIT
+      compute_tiles(transform_in, in_tile_area, out_channels, tile_count,
+                    in_channels, transform_out, jitter, m, tile);
 #else
-        const index_t idx =
-            (in_tile_area / 8) * in_channels * m + (tidx / 8) * in_channels;
-        asm_wino_multiply(a_stride, c_stride, tile_count, in_channels, mask,
-                          a_ptr, c_ptr, jitter->get_p_addr(),
-                          jitter->get_offset_data(), idx);
+      compute_tiles(transformed_filter_data, transform_in, in_tile_area,
+                    out_channels, tile_count, in_channels, transform_out, m,
+                    tile);
 #endif
-      }
     }
   }
 }
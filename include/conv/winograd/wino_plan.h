@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __WINO_PLAN_H__
+#define __WINO_PLAN_H__
+
+#include <omp.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "mem/allocator.h"
+#include "tensor/tensor.h"
+#include "types/types.h"
+#include "wino_impl.h"
+
+// WinogradPlan prepares the convolution of a constant filter with inputs of a
+// fixed shape. The filter is transformed (and, with the JIT, the multiply
+// code generated) once, the padding and tile counts are derived once and the
+// scratch is sized up front, so execute does no setup work. Changing a
+// setting re-reserves the scratch.
+template <typename T, wino_k_t W, wino_o_t O>
+class WinogradPlan {
+ private:
+  Winograd<T, W, O> engine;
+  std::vector<index_t> input_dims;
+  std::vector<index_t> filter_dims;
+  WinoGeometry geometry;
+  std::shared_ptr<Tensor<T>> transformed_filter;
+#ifdef ENABLE_JIT
+  std::shared_ptr<WinoJitter<T>> jitter;
+#endif
+
+ public:
+  WinogradPlan(const std::shared_ptr<Tensor<T>> filter,
+               const std::vector<index_t>& input_dims,
+               gemm_library lib = LIBMARLIN,
+               allocator_t scratch_allocator = CPU_ALLOCATOR);
+  void execute(const std::shared_ptr<Tensor<T>> input,
+               std::shared_ptr<Tensor<T>> output);
+  void set_num_threads(index_t num_threads) {
+    engine.set_num_threads(num_threads);
+    engine.reserve(geometry);
+  }
+  void set_fused(bool fused) {
+    engine.set_fused(fused);
+    engine.reserve(geometry);
+  }
+  void set_block_tiles(index_t block_tiles) {
+    engine.set_block_tiles(block_tiles);
+    engine.reserve(geometry);
+  }
+  // padding changes the output shape, hence the geometry is derived again.
+  // A padding the shapes do not allow leaves the plan unchanged.
+  void set_padding(const std::vector<index_t>& padding);
+  void set_same_padding() {
+    set_padding(std::vector<index_t>(4, (Winograd<T, W, O>::KERNEL - 1) / 2));
+  }
+  const WinoGeometry& get_geometry() const { return geometry; }
+  std::vector<index_t> get_output_dims() const {
+    return {geometry.batch, geometry.out_channels, geometry.out_height,
+            geometry.out_width};
+  }
+};
+
+template <typename T, wino_k_t W, wino_o_t O>
+WinogradPlan<T, W, O>::WinogradPlan(const std::shared_ptr<Tensor<T>> filter,
+                                    const std::vector<index_t>& input_dims,
+                                    gemm_library lib,
+                                    allocator_t scratch_allocator)
+    : engine(lib, scratch_allocator),
+      input_dims(input_dims),
+      filter_dims(filter->get_dims()) {
+#ifndef ENABLE_JIT
+  engine.set_switch(lib);
+#endif
+  geometry = engine.get_geometry(input_dims, filter_dims);
+
+  typedef Winograd<T, W, O> Engine;
+  const index_t out_channels = geometry.out_channels;
+  const index_t in_channels = geometry.in_channels;
+  transformed_filter = std::make_shared<Tensor<T>>();
+  transformed_filter->resize({out_channels, in_channels, Engine::TILE_AREA});
+  const T* filter_data = filter->data();
+  T* transformed_filter_data = transformed_filter->mutable_data();
+#pragma omp parallel num_threads(engine.get_num_threads())
+  engine.transform_kernel(filter_data, out_channels, in_channels,
+                          transformed_filter_data);
+#ifdef ENABLE_JIT
+  jitter = std::make_shared<WinoJitter<T>>();
+  jitter->generate_code(transformed_filter_data, Engine::TILE_AREA,
+                        in_channels, out_channels);
+#endif
+  engine.reserve(geometry);
+}
+
+template <typename T, wino_k_t W, wino_o_t O>
+void WinogradPlan<T, W, O>::set_padding(const std::vector<index_t>& padding) {
+  const std::vector<index_t> previous = engine.get_padding();
+  engine.set_padding(padding);
+  try {
+    geometry = engine.get_geometry(input_dims, filter_dims);
+  } catch (...) {
+    engine.set_padding(previous);
+    throw;
+  }
+  engine.reserve(geometry);
+}
+
+template <typename T, wino_k_t W, wino_o_t O>
+void WinogradPlan<T, W, O>::execute(const std::shared_ptr<Tensor<T>> input,
+                                    std::shared_ptr<Tensor<T>> output) {
+  if (input->get_dims() != input_dims) {
+    throw std::invalid_argument(
+        "input shape differs from the shape the plan was created for");
+  }
+#ifdef ENABLE_JIT
+  engine.execute(geometry, input, output, jitter.get());
+#else
+  engine.execute(geometry, input, output, nullptr,
+                 transformed_filter->mutable_data());
+#endif
+}
+
+#endif
@@ -0,0 +1,492 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __WINO_GENERIC_TRANSFORM_H__
+#define __WINO_GENERIC_TRANSFORM_H__
+
+#include <immintrin.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "constants/constants.h"
+#include "types/types.h"
+#include "utils/utils.h"
+
+// Transform matrices of the Winograd minimal filtering algorithm
+// F(M x M, R x R), which computes an M x M output tile from an
+// ALPHA x ALPHA (ALPHA = M + R - 1) input tile as
+//   Y = AT [(G g GT) . (BT d B)] A
+// The matrices follow the Toom-Cook construction over the interpolation
+// points 0, 1, -1, 2, -2 (ALPHA = 6) extended by 1/2, -1/2 (ALPHA = 8) and
+// infinity. Configurations without a specialization are not supported.
+template <index_t M, index_t R>
+struct WinoMatrices {
+  static constexpr bool SUPPORTED = false;
+};
+
+// F(2x2, 3x3) over the points 0, -1, 1 and infinity
+template <>
+struct WinoMatrices<2, 3> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr index_t ALPHA = 4;
+  static constexpr float BT[4][4] = {
+      {1, 0, -1, 0}, {0, 1, -1, 0}, {0, -1, -1, 0}, {0, 1, 0, -1}};
+  static constexpr float G[4][3] = {{1, 0, 0},
+                                    {-1.f / 2, 1.f / 2, -1.f / 2},
+                                    {-1.f / 2, -1.f / 2, -1.f / 2},
+                                    {0, 0, -1}};
+  static constexpr float AT[2][4] = {{1, 1, 1, 0}, {0, -1, 1, 1}};
+};
+
+template <>
+struct WinoMatrices<4, 3> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr index_t ALPHA = 6;
+  static constexpr float BT[6][6] = {{4, 0, -5, 0, 1, 0},
+                                     {0, -4, -4, 1, 1, 0},
+                                     {0, 4, -4, -1, 1, 0},
+                                     {0, -2, -1, 2, 1, 0},
+                                     {0, 2, -1, -2, 1, 0},
+                                     {0, 4, 0, -5, 0, 1}};
+  static constexpr float G[6][3] = {{1.f / 4, 0, 0},
+                                    {-1.f / 6, -1.f / 6, -1.f / 6},
+                                    {-1.f / 6, 1.f / 6, -1.f / 6},
+                                    {1.f / 24, 1.f / 12, 1.f / 6},
+                                    {1.f / 24, -1.f / 12, 1.f / 6},
+                                    {0, 0, 1}};
+  static constexpr float AT[4][6] = {{1, 1, 1, 1, 1, 0},
+                                     {0, 1, -1, 2, -2, 0},
+                                     {0, 1, 1, 4, 4, 0},
+                                     {0, 1, -1, 8, -8, 1}};
+};
+
+// F(2x2, 5x5) shares the interpolation points, hence BT, of F(4x4, 3x3)
+template <>
+struct WinoMatrices<2, 5> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr index_t ALPHA = 6;
+  static constexpr float BT[6][6] = {{4, 0, -5, 0, 1, 0},
+                                     {0, -4, -4, 1, 1, 0},
+                                     {0, 4, -4, -1, 1, 0},
+                                     {0, -2, -1, 2, 1, 0},
+                                     {0, 2, -1, -2, 1, 0},
+                                     {0, 4, 0, -5, 0, 1}};
+  static constexpr float G[6][5] = {
+      {1.f / 4, 0, 0, 0, 0},
+      {-1.f / 6, -1.f / 6, -1.f / 6, -1.f / 6, -1.f / 6},
+      {-1.f / 6, 1.f / 6, -1.f / 6, 1.f / 6, -1.f / 6},
+      {1.f / 24, 1.f / 12, 1.f / 6, 1.f / 3, 2.f / 3},
+      {1.f / 24, -1.f / 12, 1.f / 6, -1.f / 3, 2.f / 3},
+      {0, 0, 0, 0, 1}};
+  static constexpr float AT[2][6] = {{1, 1, 1, 1, 1, 0},
+                                     {0, 1, -1, 2, -2, 1}};
+};
+
+template <>
+struct WinoMatrices<4, 5> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr index_t ALPHA = 8;
+  static constexpr float BT[8][8] = {
+      {1, 0, -21.f / 4, 0, 21.f / 4, 0, -1, 0},
+      {0, 1, 1, -17.f / 4, -17.f / 4, 1, 1, 0},
+      {0, -1, 1, 17.f / 4, -17.f / 4, -1, 1, 0},
+      {0, 1.f / 2, 1.f / 4, -5.f / 2, -5.f / 4, 2, 1, 0},
+      {0, -1.f / 2, 1.f / 4, 5.f / 2, -5.f / 4, -2, 1, 0},
+      {0, 2, 4, -5.f / 2, -5, 1.f / 2, 1, 0},
+      {0, -2, 4, 5.f / 2, -5, -1.f / 2, 1, 0},
+      {0, -1, 0, 21.f / 4, 0, -21.f / 4, 0, 1}};
+  static constexpr float G[8][5] = {
+      {1, 0, 0, 0, 0},
+      {-2.f / 9, -2.f / 9, -2.f / 9, -2.f / 9, -2.f / 9},
+      {-2.f / 9, 2.f / 9, -2.f / 9, 2.f / 9, -2.f / 9},
+      {1.f / 90, 1.f / 45, 2.f / 45, 4.f / 45, 8.f / 45},
+      {1.f / 90, -1.f / 45, 2.f / 45, -4.f / 45, 8.f / 45},
+      {32.f / 45, 16.f / 45, 8.f / 45, 4.f / 45, 2.f / 45},
+      {32.f / 45, -16.f / 45, 8.f / 45, -4.f / 45, 2.f / 45},
+      {0, 0, 0, 0, 1}};
+  static constexpr float AT[4][8] = {
+      {1, 1, 1, 1, 1, 1, 1, 0},
+      {0, 1, -1, 2, -2, 1.f / 2, -1.f / 2, 0},
+      {0, 1, 1, 4, 4, 1.f / 4, 1.f / 4, 0},
+      {0, 1, -1, 8, -8, 1.f / 8, -1.f / 8, 1}};
+};
+
+// edge of the output tiles (M) and filters (R) of a configuration
+constexpr index_t wino_output_tile(wino_o_t o) {
+  return o == WINO_O_2x2 ? 2 : o == WINO_O_4x4 ? 4 : o == WINO_O_6x6 ? 6 : 8;
+}
+constexpr index_t wino_kernel_size(wino_k_t w) {
+  return w == WINO_K_3x3 ? 3 : w == WINO_K_5x5 ? 5 : 7;
+}
+
+// number of transformed tile positions stored per channel: ALPHA * ALPHA
+// rounded up to whole rounds of the elementwise multiply
+constexpr index_t wino_tile_area(index_t m, index_t r) {
+  return RoundUp((m + r - 1) * (m + r - 1), WINO_POSITIONS_PER_ROUND);
+}
+
+inline __mmask16 wino_lane_mask(index_t lanes) {
+  return lanes >= 16 ? 0xffff : static_cast<__mmask16>(~(0xffff << lanes));
+}
+
+// y = C x for a matrix C known at compile time. Zero coefficients are skipped
+// and unit coefficients become additions / subtractions.
+template <index_t Rows, index_t Cols, const float (&C)[Rows][Cols]>
+FORCE_INLINE inline void wino_matvec(const __m512 (&x)[Cols],
+                                     __m512 (&y)[Rows]) {
+  static_for<Rows>([&](auto i) FORCE_INLINE {
+    __m512 acc = _mm512_setzero_ps();
+    static_for<Cols>([&](auto k) FORCE_INLINE {
+      constexpr float c = C[decltype(i)::value][decltype(k)::value];
+      if constexpr (c == 1.f) {
+        acc = _mm512_add_ps(acc, x[k]);
+      } else if constexpr (c == -1.f) {
+        acc = _mm512_sub_ps(acc, x[k]);
+      } else if constexpr (c != 0.f) {
+        acc = _mm512_fmadd_ps(_mm512_set1_ps(c), x[k], acc);
+      }
+    });
+    y[i] = acc;
+  });
+}
+
+// lanes i with lo <= i < hi
+inline __mmask16 wino_range_mask(int64_t lo, int64_t hi) {
+  lo = std::max<int64_t>(lo, 0);
+  hi = std::min<int64_t>(hi, 16);
+  return hi > lo ? wino_lane_mask(hi) & ~wino_lane_mask(lo) : 0;
+}
+
+// Returns the vector whose lane t holds src[t * Stride]. Only src[lo, hi) is
+// read and the lanes outside of it are zero, hence src may point before or
+// run past the row it reads from.
+template <index_t Stride>
+inline __m512 wino_load_strided(const float* src, int64_t lo, int64_t hi) {
+  __m512 l[Stride];
+  static_for<Stride>([&](auto q) FORCE_INLINE {
+    const int64_t begin = q * 16;
+    l[q] = _mm512_maskz_loadu_ps(wino_range_mask(lo - begin, hi - begin),
+                                 src + begin);
+  });
+  if constexpr (Stride == 1) {
+    return l[0];
+  } else if constexpr (Stride == 2) {
+    const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18,
+                                           20, 22, 24, 26, 28, 30);
+    return _mm512_permutex2var_ps(l[0], even, l[1]);
+  } else if constexpr (Stride == 4) {
+    // every fourth element of two registers fills the lower eight lanes
+    const __m512i fourth = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, 0, 0,
+                                             0, 0, 0, 0, 0, 0);
+    const __m512i halves = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 16, 17,
+                                             18, 19, 20, 21, 22, 23);
+    const __m512 lo = _mm512_permutex2var_ps(l[0], fourth, l[1]);
+    const __m512 hi = _mm512_permutex2var_ps(l[2], fourth, l[3]);
+    return _mm512_permutex2var_ps(lo, halves, hi);
+  } else {
+    alignas(ALIGN_BYTE_SIZE) float lanes[16];
+    _mm512_store_ps(lanes, _mm512_setzero_ps());
+    for (int64_t t = 0; t < 16; ++t) {
+      if (t * Stride >= lo && t * Stride < hi) lanes[t] = src[t * Stride];
+    }
+    return _mm512_load_ps(lanes);
+  }
+}
+
+// wino_load_strided for rows whose elements are col_stride apart: lane t
+// holds element x + t * step of the row if it lies in [0, width), else zero.
+inline __m512 wino_gather_strided(const float* row, int64_t x, index_t step,
+                                  int64_t width, index_t col_stride) {
+  alignas(ALIGN_BYTE_SIZE) float lanes[16];
+  for (int64_t t = 0; t < 16; ++t) {
+    const int64_t e = x + t * static_cast<int64_t>(step);
+    lanes[t] = e >= 0 && e < width ? row[e * static_cast<int64_t>(col_stride)]
+                                   : 0.f;
+  }
+  return _mm512_load_ps(lanes);
+}
+
+// interleaves the lanes of a and b: lo = a0 b0 a1 b1 ... a7 b7 and
+// hi = a8 b8 ... a15 b15
+inline void wino_interleave(__m512 a, __m512 b, __m512* lo, __m512* hi) {
+  const __m512i first = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20,
+                                          5, 21, 6, 22, 7, 23);
+  const __m512i second = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12,
+                                           28, 13, 29, 14, 30, 15, 31);
+  *lo = _mm512_permutex2var_ps(a, first, b);
+  *hi = _mm512_permutex2var_ps(a, second, b);
+}
+
+// Writes dst[t * Stride + j] = lane t of y[j], i.e. Stride vectors of 16
+// horizontally adjacent tiles as one contiguous image row segment. Only
+// dst[0, avail) is written.
+template <index_t Stride>
+inline void wino_store_interleaved(float* dst, const __m512 (&y)[Stride],
+                                   index_t avail) {
+  __m512 o[Stride];
+  if constexpr (Stride == 1) {
+    o[0] = y[0];
+  } else if constexpr (Stride == 2) {
+    wino_interleave(y[0], y[1], &o[0], &o[1]);
+  } else if constexpr (Stride == 4) {
+    __m512 a_lo, a_hi, b_lo, b_hi;
+    wino_interleave(y[0], y[2], &a_lo, &a_hi);
+    wino_interleave(y[1], y[3], &b_lo, &b_hi);
+    wino_interleave(a_lo, b_lo, &o[0], &o[1]);
+    wino_interleave(a_hi, b_hi, &o[2], &o[3]);
+  } else {
+    alignas(ALIGN_BYTE_SIZE) float lanes[Stride][16];
+    for (index_t j = 0; j < Stride; ++j) {
+      _mm512_store_ps(lanes[j], y[j]);
+    }
+    for (index_t e = 0; e < 16 * Stride && e < avail; ++e) {
+      dst[e] = lanes[e % Stride][e / Stride];
+    }
+    return;
+  }
+  static_for<Stride>([&](auto q) FORCE_INLINE {
+    const index_t begin = q * 16;
+    if (avail > begin) {
+      _mm512_mask_storeu_ps(dst + begin, wino_lane_mask(avail - begin), o[q]);
+    }
+  });
+}
+
+// Transforms the filters [num_filters][channels][R][R] in to
+// output[position][num_filters][channels] (U = G g GT). Sixteen (filter,
+// channel) pairs are transformed at once, one per lane, hence every position
+// is written with contiguous stores. Positions beyond ALPHA * ALPHA are zero.
+//
+// The transforms use orphaned OpenMP worksharing: called from within a
+// parallel region the work is split among its threads, otherwise they run on
+// the calling thread.
+template <index_t M, index_t R>
+void wino_transform_kernel(const float* filter, const index_t num_filters,
+                           const index_t channels, float* output) {
+  using W = WinoMatrices<M, R>;
+  constexpr index_t A = W::ALPHA;
+  const index_t pairs = num_filters * channels;
+  const __m512i vindex = _mm512_mullo_epi32(
+      _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm512_set1_epi32(R * R));
+
+#pragma omp for schedule(static)
+  for (index_t p = 0; p < pairs; p += 16) {
+    const __mmask16 mask = wino_lane_mask(pairs - p);
+    const float* g_ptr = filter + p * R * R;
+    // tmp = G g, one column of g at a time
+    __m512 tmp[A][R];
+    static_for<R>([&](auto c) FORCE_INLINE {
+      __m512 col[R];
+      __m512 out[A];
+      static_for<R>([&](auto r) FORCE_INLINE {
+        col[r] = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, vindex,
+                                          g_ptr + r * R + c, 4);
+      });
+      wino_matvec<A, R, W::G>(col, out);
+      static_for<A>([&](auto a) FORCE_INLINE { tmp[a][c] = out[a]; });
+    });
+    // U = tmp GT, one row at a time
+    static_for<A>([&](auto a) FORCE_INLINE {
+      __m512 u[A];
+      wino_matvec<A, R, W::G>(tmp[a], u);
+      static_for<A>([&](auto b) FORCE_INLINE {
+        _mm512_mask_storeu_ps(output + (a * A + b) * pairs + p, mask, u[b]);
+      });
+    });
+  }
+#pragma omp single
+  memset(output + A * A * pairs, 0,
+         sizeof(float) * (wino_tile_area(M, R) - A * A) * pairs);
+}
+
+// Transforms count (at most 16) horizontally adjacent input tiles, one per
+// lane, of a height x width image whose rows are row_stride and columns
+// col_stride elements apart. The first tile starts at input row y and column
+// x, which may lie outside of the image: the elements outside of it are zero,
+// i.e. the border tiles are padded virtually by masked loads. Position p of
+// tile t is written to dst[p * stride + t].
+template <index_t M, index_t R>
+FORCE_INLINE inline void wino_input_tiles(
+    const float* image, const index_t height, const index_t width,
+    const index_t row_stride, const index_t col_stride, const int64_t y,
+    const int64_t x, const index_t count, float* dst, const index_t stride) {
+  using W = WinoMatrices<M, R>;
+  constexpr index_t A = W::ALPHA;
+  const __mmask16 mask = wino_lane_mask(count);
+  const int64_t h = height;
+  const int64_t w = width;
+  // r = d B, one input row at a time
+  __m512 r[A][A];
+  static_for<A>([&](auto k) FORCE_INLINE {
+    const int64_t row_index = y + static_cast<int64_t>(k);
+    if (row_index < 0 || row_index >= h) {
+      static_for<A>([&](auto l) FORCE_INLINE {
+        r[k][l] = _mm512_setzero_ps();
+      });
+      return;
+    }
+    const float* row = image + row_index * static_cast<int64_t>(row_stride);
+    __m512 d[A];
+    static_for<A>([&](auto l) FORCE_INLINE {
+      const int64_t begin = x + static_cast<int64_t>(l);
+      if (col_stride == 1) {
+        d[l] = wino_load_strided<M>(row + begin, -begin, w - begin);
+      } else {
+        d[l] = wino_gather_strided(row, begin, M, w, col_stride);
+      }
+    });
+    wino_matvec<A, A, W::BT>(d, r[k]);
+  });
+  // V = BT r, one column at a time
+  static_for<A>([&](auto j) FORCE_INLINE {
+    __m512 col[A];
+    __m512 v[A];
+    static_for<A>([&](auto k) FORCE_INLINE { col[k] = r[k][j]; });
+    wino_matvec<A, A, W::BT>(col, v);
+    static_for<A>([&](auto i) FORCE_INLINE {
+      _mm512_mask_storeu_ps(dst + (i * A + j) * stride, mask, v[i]);
+    });
+  });
+}
+
+// Inverse of count (at most 16) horizontally adjacent tiles whose position p
+// of tile t is src[p * stride + t]. The M x M results are interleaved in to
+// the output rows starting at row y and column x of a height x width image
+// (row_stride and col_stride elements between rows and columns). Only the
+// pixels inside of the image are written.
+template <index_t M, index_t R>
+FORCE_INLINE inline void wino_output_tiles(
+    const float* src, const index_t stride, const index_t count, float* image,
+    const index_t height, const index_t width, const index_t row_stride,
+    const index_t col_stride, const index_t y, const index_t x) {
+  using W = WinoMatrices<M, R>;
+  constexpr index_t A = W::ALPHA;
+  const __mmask16 mask = wino_lane_mask(count);
+  // r = s A, one row of positions at a time
+  __m512 r[A][M];
+  static_for<A>([&](auto k) FORCE_INLINE {
+    __m512 s[A];
+    static_for<A>([&](auto l) FORCE_INLINE {
+      s[l] = _mm512_maskz_loadu_ps(mask, src + (k * A + l) * stride);
+    });
+    wino_matvec<M, A, W::AT>(s, r[k]);
+  });
+  // Y = AT r, one column at a time
+  __m512 out[M][M];
+  static_for<M>([&](auto j) FORCE_INLINE {
+    __m512 col[A];
+    __m512 o[M];
+    static_for<A>([&](auto k) FORCE_INLINE { col[k] = r[k][j]; });
+    wino_matvec<M, A, W::AT>(col, o);
+    static_for<M>([&](auto i) FORCE_INLINE { out[i][j] = o[i]; });
+  });
+  const index_t avail = std::min(count * M, width - x);
+  static_for<M>([&](auto i) FORCE_INLINE {
+    if (y + i >= height) return;
+    float* row = image + (y + i) * row_stride + x * col_stride;
+    if (col_stride == 1) {
+      wino_store_interleaved<M>(row, out[i], avail);
+    } else {
+      alignas(ALIGN_BYTE_SIZE) float lanes[M][16];
+      for (index_t j = 0; j < M; ++j) _mm512_store_ps(lanes[j], out[i][j]);
+      for (index_t e = 0; e < avail; ++e) {
+        row[e * col_stride] = lanes[e % M][e / M];
+      }
+    }
+  });
+}
+
+// Transforms the input images [batch][in_channels][height][width] (with the
+// given element strides) in to output[batch][position][in_channels]
+// [tiles_h * tiles_w] (V = BT d B). The first tile starts at row -pad_top and
+// column -pad_left and the tiles past the borders read zeros, hence the input
+// is never copied in to a padded image. Each step handles 16 horizontally
+// adjacent tiles, one per lane, and every position is written with one
+// contiguous store.
+template <index_t M, index_t R>
+void wino_transform_input(const float* input, const index_t batch,
+                          const index_t in_channels, const index_t height,
+                          const index_t width, const index_t batch_stride,
+                          const index_t channel_stride,
+                          const index_t row_stride, const index_t col_stride,
+                          const index_t pad_top, const index_t pad_left,
+                          const index_t tiles_h, const index_t tiles_w,
+                          float* output) {
+  constexpr index_t A = WinoMatrices<M, R>::ALPHA;
+  const index_t tile_count = tiles_h * tiles_w;
+  const index_t stride = in_channels * tile_count;
+  const index_t output_batch_size = wino_tile_area(M, R) * stride;
+
+#pragma omp for collapse(2) schedule(static) nowait
+  for (index_t n = 0; n < batch; ++n) {
+    for (index_t c = 0; c < in_channels; ++c) {
+      const float* image = input + n * batch_stride + c * channel_stride;
+      float* out_channel = output + n * output_batch_size + c * tile_count;
+      for (index_t th = 0; th < tiles_h; ++th) {
+        const int64_t y = static_cast<int64_t>(th * M) - pad_top;
+        for (index_t tw = 0; tw < tiles_w; tw += 16) {
+          const int64_t x = static_cast<int64_t>(tw * M) - pad_left;
+          wino_input_tiles<M, R>(image, height, width, row_stride, col_stride,
+                                 y, x, std::min<index_t>(tiles_w - tw, 16),
+                                 out_channel + th * tiles_w + tw, stride);
+        }
+      }
+    }
+  }
+  // padding positions are multiplied but never read back
+#pragma omp for schedule(static)
+  for (index_t n = 0; n < batch; ++n) {
+    memset(output + n * output_batch_size + A * A * stride, 0,
+           sizeof(float) * (wino_tile_area(M, R) - A * A) * stride);
+  }
+}
+
+// Transforms input[batch][position][out_channels][tiles_h * tiles_w] back to
+// the output images [batch][out_channels][height][width] (with the given
+// element strides), Y = AT m A. Only the pixels inside of the images are
+// written, so the output needs no padding. Each step handles 16 horizontally
+// adjacent tiles: every position is read with one contiguous load and the
+// M x M results are interleaved in to the output rows. The
+// (batch, out_channel) images are independent and shared among the threads
+// of the team.
+template <index_t M, index_t R>
+void wino_transform_output(const float* input, const index_t batch,
+                           const index_t out_channels, const index_t tiles_h,
+                           const index_t tiles_w, float* output,
+                           const index_t height, const index_t width,
+                           const index_t batch_stride,
+                           const index_t channel_stride,
+                           const index_t row_stride,
+                           const index_t col_stride) {
+  const index_t tile_count = tiles_h * tiles_w;
+  const index_t stride = out_channels * tile_count;
+  const index_t input_batch_size = wino_tile_area(M, R) * stride;
+
+#pragma omp for collapse(2) schedule(static)
+  for (index_t n = 0; n < batch; ++n) {
+    for (index_t m = 0; m < out_channels; ++m) {
+      const float* in_channel = input + n * input_batch_size + m * tile_count;
+      float* image = output + n * batch_stride + m * channel_stride;
+      for (index_t th = 0; th < tiles_h; ++th) {
+        for (index_t tw = 0; tw < tiles_w; tw += 16) {
+          wino_output_tiles<M, R>(in_channel + th * tiles_w + tw, stride,
+                                  std::min<index_t>(tiles_w - tw, 16), image,
+                                  height, width, row_stride, col_stride,
+                                  th * M, tw * M);
+        }
+      }
+    }
+  }
+}
+
+#endif
@@ -13,69 +13,10 @@
 
 #include "../types/types.h"
 
-extern "C" index_t asm_gemm_f32_j1(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j2(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j3(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j4(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j5(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j6(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j7(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j8(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j9(index_t m, index_t k, index_t n, float *a,
-                                   float *c, void *p_addr, index_t *offset_data,
-                                   uint16_t mask, index_t idx);
-
-extern "C" index_t asm_gemm_f32_j10(index_t m, index_t k, index_t n, float *a,
-                                    float *c, void *p_addr,
-                                    index_t *offset_data, uint16_t mask,
-                                    index_t idx);
-
-extern "C" index_t asm_gemm_f32_j11(index_t m, index_t k, index_t n, float *a,
-                                    float *c, void *p_addr,
-                                    index_t *offset_data, uint16_t mask,
-                                    index_t idx);
-
-extern "C" index_t asm_gemm_f32_j12(index_t m, index_t k, index_t n, float *a,
-                                    float *c, void *p_addr,
-                                    index_t *offset_data, uint16_t mask,
-                                    index_t idx);
-
-extern "C" index_t asm_gemm_f32_j13(index_t m, index_t k, index_t n, float *a,
-                                    float *c, void *p_addr,
-                                    index_t *offset_data, uint16_t mask,
-                                    index_t idx);
-
-extern "C" index_t asm_gemm_f32_j14(index_t m, index_t k, index_t n, float *a,
-                                    float *c, void *p_addr,
-                                    index_t *offset_data, uint16_t mask,
-                                    index_t idx);
-
-extern "C" index_t asm_gemm(index_t m, index_t k, index_t n, float *a, float *c,
-                            void *p_addr, index_t *offset_data, uint16_t mask,
-                            index_t idx);
+// lda and ldc are the column strides of the column major A and C tiles
+extern "C" index_t asm_gemm(index_t lda, index_t k, index_t ldc, float *a,
+                            float *c, void *p_addr, index_t *offset_data,
+                            uint16_t mask, index_t idx, index_t accumulate,
+                            index_t prefetch_distance);
 
 #endif
\ No newline at end of file
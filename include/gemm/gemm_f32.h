@@ -14,17 +14,47 @@
 #include <immintrin.h>
 #include <memory.h>
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 #include "../types/types.h"
 #ifdef ENABLE_JIT
 #include "asm_kernels.h"
 #include "jit/jitter.h"
-#else
-#include "./kernels.h"
 #endif
+#include "../mem/arena_allocator.h"
+#include "../mem/memory.h"
+#include "./kernels.h"
+#include "./pack.h"
 
 namespace MARLIN {
+// Intrinsic kernel GEMM over MRows x NCols register tiles (see
+// gemm_f32_kernel). Each A panel of MRows rows is packed once and reused for
+// every column tile. Column tiles narrower than NCols are dispatched through
+// the kernel table of the tile shape. The panel is taken from the thread
+// arena, so steady state calls do not reach the heap.
+template <index_t MRows, index_t NCols>
+inline index_t sgemm_tiled(char transa, char transb, index_t m, index_t n,
+                           index_t k, float alpha, float* a, index_t lda,
+                           float* b, index_t ldb, float beta, float* c,
+                           index_t ldc) {
+  const auto& kernels = gemm_f32_kernel_table<MRows, NCols>;
+  WorkspaceScope scope;
+  float* panel = static_cast<float*>(
+      Arena::get_thread_arena().allocate(MRows * k * sizeof(float)));
+  for (index_t i = 0; i < m; i += MRows) {
+    const index_t ielem = std::min(MRows, m - i);
+    pack_a_panel(a + i * lda, lda, ielem, k, panel, MRows);
+    for (index_t j = 0; j < n; j += NCols) {
+      const index_t jelem = std::min(NCols, n - j);
+      kernels[jelem - 1]('N', 'N', ielem, jelem, k, 1, panel, MRows, b + j,
+                         ldb, 0, c + i * ldc + j, ldc);
+    }
+  }
+  return 1;
+}
+
 // Performs GEMM (General Matrix Multiplication)
 // block size for all three dimensions is set to the above "N" value by
 // default.
@@ -40,232 +70,89 @@ namespace MARLIN {
 // k      - numer of columns in matrix A and rows in matrix B (row major)
 // alpha  - factor of matrix A (alpha * AB + beta * C) @TODO(malith):
 // a      - pointer of type T of matrix A
-// lda    - leading dimension of matrix A (stride offset) @TODO(malith):
+// lda    - leading dimension of matrix A (stride offset)
 // b      - pointer of type T of matrix B
-// ldb    - leading dimension of matrix B (stride offset) @TODO(malith):
+// ldb    - leading dimension of matrix B (stride offset)
 // beta   - factor of matrix B (alpha * AB + beta * C) @TODO(malith):
 // c      - pointer of type T of matrix C
-// ldc    - leading dimension of matrix C (stride offset) @TODO(malith):
+// ldc    - leading dimension of matrix C (stride offset)
+// compiled - handle to the code generated for B (JIT only). The handle is
+//            read only, hence concurrent calls sharing it are thread safe.
+//
+// The JIT kernels read A and write C column major, so lda and ldc are the
+// column strides (at least m) and B, baked in to the code, ignores ldb.
 #ifdef ENABLE_JIT
 inline index_t sgemm(char transa, char transb, index_t m, index_t n, index_t k,
                      float alpha, float* a, index_t lda, float* b, index_t ldb,
                      float beta, float* c, index_t ldc,
-                     std::shared_ptr<Jitter<float>> jitter) {
-#else
-inline index_t sgemm(char transa, char transb, index_t m, index_t n, index_t k,
-                     float alpha, float* a, index_t lda, float* b, index_t ldb,
-                     float beta, float* c, index_t ldc) {
-#endif
+                     const CompiledGemm& compiled) {
+  if (lda < m || ldc < m) {
+    throw std::invalid_argument("lda and ldc must be at least m");
+  }
+  // shape specialized jitters compute the whole GEMM of dense operands in a
+  // single call
+  fused_gemm_t fused_kernel = compiled.get_fused_kernel(m, k, n);
+  if (fused_kernel != nullptr && lda == m && ldc == m) {
+    fused_kernel(a, c);
+    return 1;
+  }
+  float* a_ptr;
+  float* c_ptr;
   // full tile bounding limit
   index_t ftile_j_lim = (n / 15) * 15;
   index_t ftile_i_lim = m & ~(0xf);
-  // partial tile bounding limit
-  index_t ptile_j_remain = n - ftile_j_lim;
-  index_t ptile_i_remain = m & 0xf;
-  float* a_ptr;
-  float* c_ptr;
-#ifdef ENABLE_JIT
   index_t idx = 0;
-#else
-  float* b_ptr;
-#endif
-
-#ifdef ENABLE_JIT
-  auto execute_kernel = [&](uint16_t mask, index_t jelem) {
-    switch (jelem) {
-      case 1:
-        asm_gemm_f32_j1(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 2:
-        asm_gemm_f32_j2(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 3:
-        asm_gemm_f32_j3(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 4:
-        asm_gemm_f32_j4(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 5:
-        asm_gemm_f32_j5(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 6:
-        asm_gemm_f32_j6(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 7:
-        asm_gemm_f32_j7(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 8:
-        asm_gemm_f32_j8(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 9:
-        asm_gemm_f32_j9(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                        jitter->get_offset_data(), mask, idx);
-        break;
-      case 10:
-        asm_gemm_f32_j10(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                         jitter->get_offset_data(), mask, idx);
-        break;
-      case 11:
-        asm_gemm_f32_j11(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                         jitter->get_offset_data(), mask, idx);
-        break;
-      case 12:
-        asm_gemm_f32_j12(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                         jitter->get_offset_data(), mask, idx);
-        break;
-      case 13:
-        asm_gemm_f32_j13(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                         jitter->get_offset_data(), mask, idx);
-        break;
-      case 14:
-        asm_gemm_f32_j14(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-                         jitter->get_offset_data(), mask, idx);
-        break;
-    }
-  };
-#else
-  auto execute_kernel = [&](index_t ielem, index_t jelem) {
-    switch (jelem) {
-      case 1:
-        gemm_f32_j1('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 2:
-        gemm_f32_j2('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 3:
-        gemm_f32_j3('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 4:
-        gemm_f32_j4('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 5:
-        gemm_f32_j5('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 6:
-        gemm_f32_j6('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 7:
-        gemm_f32_j7('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 8:
-        gemm_f32_j8('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 9:
-        gemm_f32_j9('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                    n);
-        break;
-      case 10:
-        gemm_f32_j10('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                     n);
-        break;
-      case 11:
-        gemm_f32_j11('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                     n);
-        break;
-      case 12:
-        gemm_f32_j12('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                     n);
-        break;
-      case 13:
-        gemm_f32_j13('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                     n);
-        break;
-      case 14:
-        gemm_f32_j14('N', 'N', ielem, jelem, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr,
-                     n);
-        break;
-    }
-  };
-#endif
-
-  for (index_t i = 0; i < ftile_i_lim; i += 0x10) {
-    for (index_t j = 0; j < ftile_j_lim; j += 0xf) {
-#ifdef ENABLE_JIT
-      a_ptr = a + i;
-      c_ptr = c + i + j * m;
-      asm_gemm(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-               jitter->get_offset_data(), jitter->get_mask(),
-               idx + (j / 15) * k);
-#else
-      a_ptr = a + i * k;
-      c_ptr = c + i * n + j;
-      b_ptr = b + j;
-      gemm_f32_j15('N', 'N', 0x10, 0xf, k, 1, a_ptr, k, b_ptr, n, 0, c_ptr, n);
-#endif
-    }
-  }
+  index_t kb = k;
+  index_t acc = 0;
+  // row masks and prefetch distance depend on m and are derived per call
+  const uint16_t mask = CompiledGemm::get_mask();
+  const uint16_t pmask = CompiledGemm::get_pmask(m);
+  const index_t pf = compiled.get_prefetch_distance(m);
 
-  if (ptile_i_remain) {
-#ifdef ENABLE_JIT
-    a_ptr = a + ftile_i_lim;
-#else
-    a_ptr = a + ftile_i_lim * k;
-#endif
-    for (index_t j = 0; j < ftile_j_lim; j += 0xf) {
-#ifdef ENABLE_JIT
-      c_ptr = c + ftile_i_lim + j * m;
-
-      asm_gemm(m, k, n, a_ptr, c_ptr, jitter->get_p_addr(),
-               jitter->get_offset_data(), jitter->get_pmask(),
-               idx + (j / 15) * k);
-#else
-      b_ptr = b + j;
-      c_ptr = c + ftile_i_lim * n + j;
-      gemm_f32_j15('N', 'N', ptile_i_remain, 0xf, k, 1, a_ptr, k, b_ptr, n, 0,
-                   c_ptr, n);
-#endif
-    }
-  }
-
-#ifdef ENABLE_JIT
-  idx += (ftile_j_lim / 15) * k;
-#endif
-
-  if (ptile_j_remain) {
-#ifndef ENABLE_JIT
-    b_ptr = b + ftile_j_lim;
-#endif
-    for (index_t i = 0; i < ftile_i_lim; i += 0x10) {
-#ifdef ENABLE_JIT
-      a_ptr = a + i;
-      c_ptr = c + i + ftile_j_lim * m;
-      execute_kernel(jitter->get_mask(), ptile_j_remain);
-#else
-      a_ptr = a + i * k;
-      c_ptr = c + i * n + ftile_j_lim;
-      execute_kernel(0x10, ptile_j_remain);
-#endif
+  // The generated B code of a column tile is split in to k segments that fit
+  // in L1i. Each segment is streamed over all row tiles before moving to the
+  // next segment, accumulating partial products in C.
+  const index_t k_block = compiled.k_block;
+  for (index_t j = 0; j < n; j += 0xf) {
+    for (index_t kk = 0; kk < k; kk += k_block) {
+      kb = std::min(k_block, k - kk);
+      acc = kk != 0;
+      idx = (j / 15) * k + kk;
+      for (index_t i = 0; i < m; i += 0x10) {
+        a_ptr = a + i + kk * lda;
+        c_ptr = c + i + j * ldc;
+        const uint16_t row_mask = i < ftile_i_lim ? mask : pmask;
+        if (j < ftile_j_lim) {
+          asm_gemm(lda, kb, ldc, a_ptr, c_ptr, compiled.p_addr,
+                   compiled.offset_data, row_mask, idx, acc, pf);
+        } else {
+          // n % 15 remainder columns use the kernel generated for them
+          compiled.remainder_kernel(lda, kb, ldc, a_ptr, c_ptr,
+                                    compiled.p_addr, compiled.offset_data,
+                                    row_mask, idx, acc, pf);
+        }
+      }
     }
   }
+  return 1;
+}
 
-  if (ptile_i_remain && ptile_j_remain) {
-#ifdef ENABLE_JIT
-    a_ptr = a + ftile_i_lim;
-    c_ptr = c + ftile_i_lim + ftile_j_lim * m;
-    execute_kernel(jitter->get_pmask(), ptile_j_remain);
+// Convenience overload taking the Jitter. Multi threaded callers should fetch
+// jitter->get_compiled() once and share the handle instead.
+inline index_t sgemm(char transa, char transb, index_t m, index_t n, index_t k,
+                     float alpha, float* a, index_t lda, float* b, index_t ldb,
+                     float beta, float* c, index_t ldc,
+                     const std::shared_ptr<Jitter<float>>& jitter) {
+  return sgemm(transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+               jitter->get_compiled());
+}
 #else
-    a_ptr = a + ftile_i_lim * k;
-    c_ptr = c + ftile_i_lim * n + ftile_j_lim;
-    execute_kernel(ptile_i_remain, ptile_j_remain);
-#endif
-  }
-  return 1;
+inline index_t sgemm(char transa, char transb, index_t m, index_t n, index_t k,
+                     float alpha, float* a, index_t lda, float* b, index_t ldb,
+                     float beta, float* c, index_t ldc) {
+  return sgemm_tiled<A_PANEL_ROWS, 15>(transa, transb, m, n, k, alpha, a, lda,
+                                       b, ldb, beta, c, ldc);
 }
+#endif
 }  // namespace MARLIN
 #endif
\ No newline at end of file
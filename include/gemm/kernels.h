@@ -11,20 +11,27 @@
 #ifndef __KERNELS_H_
 #define __KERNELS_H_
 
-#include "./kernels/gemm_f32_j1.h"
-#include "./kernels/gemm_f32_j10.h"
-#include "./kernels/gemm_f32_j11.h"
-#include "./kernels/gemm_f32_j12.h"
-#include "./kernels/gemm_f32_j13.h"
-#include "./kernels/gemm_f32_j14.h"
-#include "./kernels/gemm_f32_j15.h"
-#include "./kernels/gemm_f32_j2.h"
-#include "./kernels/gemm_f32_j3.h"
-#include "./kernels/gemm_f32_j4.h"
-#include "./kernels/gemm_f32_j5.h"
-#include "./kernels/gemm_f32_j6.h"
-#include "./kernels/gemm_f32_j7.h"
-#include "./kernels/gemm_f32_j8.h"
-#include "./kernels/gemm_f32_j9.h"
+#include <array>
+#include <utility>
 
-#endif
\ No newline at end of file
+#include "../types/types.h"
+#include "./kernels/gemm_f32_kernel.h"
+
+typedef index_t (*gemm_f32_kernel_t)(char, char, index_t, index_t, index_t,
+                                     float, float*, index_t, float*, index_t,
+                                     float, float*, index_t);
+
+template <index_t MRows, index_t... N>
+constexpr std::array<gemm_f32_kernel_t, sizeof...(N)>
+make_gemm_f32_kernel_table(std::integer_sequence<index_t, N...>) {
+  return {{&gemm_f32_kernel<N + 1, MRows>...}};
+}
+
+// Dispatch table of an MRows x NCols tile shape. Entry j - 1 computes a tile
+// of j columns, covering the n % NCols remainder of the column tiles.
+template <index_t MRows, index_t NCols>
+inline constexpr std::array<gemm_f32_kernel_t, NCols> gemm_f32_kernel_table =
+    make_gemm_f32_kernel_table<MRows>(
+        std::make_integer_sequence<index_t, NCols>{});
+
+#endif
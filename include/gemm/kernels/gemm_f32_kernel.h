@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __GEMM_F32_KERNEL_H_
+#define __GEMM_F32_KERNEL_H_
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "../../mat/transpose.h"
+#include "../../types/types.h"
+#include "../../utils/utils.h"
+
+// Computes C = A * B (beta == 0) or C += A * B (otherwise) for a tile of m
+// (<= MRows) rows and n (= NCols) columns. a is a packed A panel of MRows
+// rows (see pack_a_panel) and lda is the distance between its k columns. B
+// and C are row major. The rows of a C column are held in MRows / 16
+// registers, hence the tile keeps NCols * ceil(MRows / 16) accumulators. C is
+// accessed with contiguous row loads / stores and transposed in registers in
+// 16x16 blocks.
+template <index_t NCols, index_t MRows>
+inline index_t gemm_f32_kernel(char transa, char transb, index_t m, index_t n,
+                               index_t k, float alpha, float* a, index_t lda,
+                               float* b, index_t ldb, float beta, float* c,
+                               index_t ldc) {
+  static_assert(NCols > 0, "tile requires at least one column");
+  static_assert(MRows > 0 && MRows % 8 == 0 && MRows <= 32,
+                "tile rows must be 8, 16, 24 or 32");
+  // registers per C column and 16 wide column blocks of C
+  constexpr index_t MV = (MRows + 15) / 16;
+  constexpr index_t NB = (NCols + 15) / 16;
+  // accumulators, A registers and the B broadcast
+  static_assert(MV * NCols + MV + 1 <= 32, "tile exceeds the ZMM registers");
+
+  __m512 acc[MV][NCols];
+  __m512 rows[16];
+
+  if (beta == 0) {
+    // C is overwritten, hence it is not read
+    static_for<MV>([&](auto v) FORCE_INLINE {
+      static_for<NCols>(
+          [&](auto j) FORCE_INLINE { acc[v][j] = _mm512_setzero_ps(); });
+    });
+  } else {
+    // load C
+    static_for<MV>([&](auto v) FORCE_INLINE {
+      static_for<NB>([&](auto cb) FORCE_INLINE {
+        constexpr index_t cols = std::min<index_t>(16, NCols - cb * 16);
+        constexpr __mmask16 col_mask =
+            static_cast<__mmask16>(~(0xffffffff << cols));
+        static_for<16>([&](auto i) FORCE_INLINE {
+          rows[i] = v * 16 + i < m ? _mm512_maskz_loadu_ps(
+                                         col_mask, c + (v * 16 + i) * ldc +
+                                                       cb * 16)
+                                   : _mm512_setzero_ps();
+        });
+        transpose16x16(rows);
+        static_for<cols>(
+            [&](auto j) FORCE_INLINE { acc[v][cb * 16 + j] = rows[j]; });
+      });
+    });
+  }
+
+  for (index_t kk = 0; kk < k; ++kk) {
+    __m512 azmm[MV];
+    static_for<MV>([&](auto v) FORCE_INLINE {
+      constexpr index_t lanes = std::min<index_t>(16, MRows - v * 16);
+      if constexpr (lanes == 16) {
+        azmm[v] = _mm512_loadu_ps(a + kk * lda + v * 16);
+      } else {
+        constexpr __mmask16 lane_mask =
+            static_cast<__mmask16>(~(0xffffffff << lanes));
+        azmm[v] = _mm512_maskz_loadu_ps(lane_mask, a + kk * lda + v * 16);
+      }
+    });
+    const float* b_row = b + kk * ldb;
+    static_for<NCols>([&](auto j) FORCE_INLINE {
+      const __m512 bzmm = _mm512_set1_ps(b_row[j]);
+      static_for<MV>([&](auto v) FORCE_INLINE {
+        acc[v][j] = _mm512_fmadd_ps(azmm[v], bzmm, acc[v][j]);
+      });
+    });
+  }
+
+  // store C
+  static_for<MV>([&](auto v) FORCE_INLINE {
+    static_for<NB>([&](auto cb) FORCE_INLINE {
+      constexpr index_t cols = std::min<index_t>(16, NCols - cb * 16);
+      constexpr __mmask16 col_mask =
+          static_cast<__mmask16>(~(0xffffffff << cols));
+      static_for<16>([&](auto j) FORCE_INLINE {
+        if constexpr (j < cols) {
+          rows[j] = acc[v][cb * 16 + j];
+        } else {
+          rows[j] = _mm512_setzero_ps();
+        }
+      });
+      transpose16x16(rows);
+      static_for<16>([&](auto i) FORCE_INLINE {
+        if (v * 16 + i < m) {
+          _mm512_mask_storeu_ps(c + (v * 16 + i) * ldc + cb * 16, col_mask,
+                                rows[i]);
+        }
+      });
+    });
+  });
+  return 1;
+}
+
+#endif
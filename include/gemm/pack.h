@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __PACK_H_
+#define __PACK_H_
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+#include "../mat/transpose.h"
+#include "../types/types.h"
+
+// number of rows in a packed A panel (one ZMM register of floats)
+const index_t A_PANEL_ROWS = 16;
+
+// Packs m (<= panel_rows) rows of the row major matrix A (k columns, leading
+// dimension lda) in to a column major panel of panel_rows floats per k column,
+// i.e. panel[kk * panel_rows + r] = a[r * lda + kk]. panel_rows must be a
+// multiple of 8. Rows beyond m are zero filled so that kernels can use full
+// width loads. Blocks of 16x16 are transposed in registers.
+inline void pack_a_panel(const float* a, index_t lda, index_t m, index_t k,
+                         float* panel, index_t panel_rows = A_PANEL_ROWS) {
+  __m512 rows[A_PANEL_ROWS];
+  for (index_t rb = 0; rb < panel_rows; rb += A_PANEL_ROWS) {
+    const index_t lanes = std::min(A_PANEL_ROWS, panel_rows - rb);
+    const __mmask16 lane_mask = static_cast<__mmask16>(~(0xffffffff << lanes));
+    for (index_t kk = 0; kk < k; kk += A_PANEL_ROWS) {
+      const index_t kelem = std::min(A_PANEL_ROWS, k - kk);
+      const __mmask16 kmask = static_cast<__mmask16>(~(0xffffffff << kelem));
+      for (index_t i = 0; i < A_PANEL_ROWS; ++i) {
+        rows[i] = rb + i < m
+                      ? _mm512_maskz_loadu_ps(kmask, a + (rb + i) * lda + kk)
+                      : _mm512_setzero_ps();
+      }
+      transpose16x16(rows);
+      for (index_t c = 0; c < kelem; ++c) {
+        _mm512_mask_storeu_ps(panel + (kk + c) * panel_rows + rb, lane_mask,
+                              rows[c]);
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __ASM_EMITTER_H_
+#define __ASM_EMITTER_H_
+
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../types/types.h"
+
+// general purpose register numbering used by the x86-64 encoding
+enum gpr_t : unsigned char {
+  RAX = 0,
+  RCX = 1,
+  RDX = 2,
+  RBX = 3,
+  RSP = 4,
+  RBP = 5,
+  RSI = 6,
+  RDI = 7,
+  R8 = 8,
+  R9 = 9,
+  R10 = 10,
+  R11 = 11,
+  R12 = 12,
+  R13 = 13,
+  R14 = 14,
+  R15 = 15
+};
+
+// AsmEmitter appends x86-64 / AVX-512 machine code to a byte vector. Only the
+// handful of instructions required by the generated GEMM kernels are
+// supported. Fixed instruction sequences are emitted as raw bytes while
+// instructions that vary with the ZMM register, mask or displacement are
+// encoded here. Jumps always use 32 bit displacements and are patched once
+// the target is known.
+class AsmEmitter {
+ private:
+  std::vector<unsigned char> code;
+  // EVEX prefix followed by the opcode and ModRM byte
+  void evex(unsigned char map, unsigned char pp, unsigned char opcode,
+            unsigned char reg, unsigned char vvvv, unsigned char rm,
+            bool rm_is_zmm, unsigned char aaa, bool zeroing);
+  // ModRM (and SIB) bytes addressing [base + disp]
+  void mem_operand(unsigned char reg, unsigned char base, int32_t disp);
+  void check_zmm(unsigned char zmm);
+
+ public:
+  AsmEmitter() = default;
+  ~AsmEmitter() = default;
+  index_t size() const { return code.size(); }
+  const std::vector<unsigned char>& get_code() const { return code; }
+  void raw(std::initializer_list<unsigned char> bytes);
+  void imm32(uint32_t value);
+  // vxorps zmm, zmm, zmm
+  void vxorps(unsigned char zmm);
+  // vfmadd231ps dst, src1, src2 (dst += src1 * src2)
+  void vfmadd231ps(unsigned char dst, unsigned char src1, unsigned char src2);
+  // vmovups zmm{k}{z}, [base + disp]
+  void vmovups_load(unsigned char zmm, unsigned char base, int32_t disp,
+                    unsigned char kmask, bool zeroing);
+  // vmovups [base + disp]{k}, zmm
+  void vmovups_store(unsigned char zmm, unsigned char base, int32_t disp,
+                     unsigned char kmask);
+  // mov eax, imm32 ; vpbroadcastd zmm, eax
+  void broadcast_imm(unsigned char zmm, uint32_t value);
+  // mov eax, imm32 ; kmovw k, eax
+  void kmovw_imm(unsigned char kmask, uint16_t value);
+  // prefetcht0 / prefetcht1 [base + disp] (hint: 1 = T0, 2 = T1)
+  void prefetch(unsigned char hint, unsigned char base, int32_t disp);
+  // jmp / jcc with a rel32 displacement. returns the position to patch.
+  index_t jmp();
+  index_t jcc(unsigned char condition);
+  // point the rel32 displacement recorded at pos to the target position
+  void patch(index_t pos, index_t target);
+};
+
+inline void AsmEmitter::check_zmm(unsigned char zmm) {
+  if (zmm > 31) {
+    throw std::invalid_argument("invalid ZMM register: " +
+                                std::to_string(zmm));
+  }
+}
+
+inline void AsmEmitter::raw(std::initializer_list<unsigned char> bytes) {
+  code.insert(code.end(), bytes.begin(), bytes.end());
+}
+
+inline void AsmEmitter::imm32(uint32_t value) {
+  unsigned char buffer[4];
+  std::memcpy(buffer, &value, sizeof(buffer));
+  code.insert(code.end(), buffer, buffer + sizeof(buffer));
+}
+
+// EVEX layout (512 bit vector length):
+//  P0 : R X B R' 0 0 m m  (R, X, B, R' inverted)
+//  P1 : W v v v v 1 p p   (vvvv inverted)
+//  P2 : z L'L b V' a a a  (V' inverted, L'L = 10)
+inline void AsmEmitter::evex(unsigned char map, unsigned char pp,
+                             unsigned char opcode, unsigned char reg,
+                             unsigned char vvvv, unsigned char rm,
+                             bool rm_is_zmm, unsigned char aaa, bool zeroing) {
+  unsigned char p0 = map;
+  p0 |= ((~reg >> 3) & 0x1) << 7;
+  p0 |= (rm_is_zmm ? ((~rm >> 4) & 0x1) : 0x1) << 6;
+  p0 |= ((~rm >> 3) & 0x1) << 5;
+  p0 |= ((~reg >> 4) & 0x1) << 4;
+  unsigned char p1 = ((~vvvv & 0xf) << 3) | 0x4 | pp;
+  unsigned char p2 = (zeroing ? 0x80 : 0x0) | 0x40;
+  p2 |= ((~vvvv >> 4) & 0x1) << 3;
+  p2 |= aaa & 0x7;
+  raw({0x62, p0, p1, p2, opcode});
+}
+
+inline void AsmEmitter::mem_operand(unsigned char reg, unsigned char base,
+                                    int32_t disp) {
+  // RBP / R13 cannot be addressed without a displacement
+  const bool has_disp = disp != 0 || (base & 0x7) == RBP;
+  const unsigned char mod = has_disp ? 0x80 : 0x00;
+  code.push_back(mod | ((reg & 0x7) << 3) | (base & 0x7));
+  // RSP / R12 require a SIB byte
+  if ((base & 0x7) == RSP) code.push_back(0x24);
+  if (has_disp) imm32(static_cast<uint32_t>(disp));
+}
+
+inline void AsmEmitter::vxorps(unsigned char zmm) {
+  check_zmm(zmm);
+  evex(0x1, 0x0, 0x57, zmm, zmm, zmm, true, 0, false);
+  code.push_back(0xc0 | ((zmm & 0x7) << 3) | (zmm & 0x7));
+}
+
+inline void AsmEmitter::vfmadd231ps(unsigned char dst, unsigned char src1,
+                                    unsigned char src2) {
+  check_zmm(dst);
+  check_zmm(src1);
+  check_zmm(src2);
+  evex(0x2, 0x1, 0xb8, dst, src1, src2, true, 0, false);
+  code.push_back(0xc0 | ((dst & 0x7) << 3) | (src2 & 0x7));
+}
+
+inline void AsmEmitter::vmovups_load(unsigned char zmm, unsigned char base,
+                                     int32_t disp, unsigned char kmask,
+                                     bool zeroing) {
+  check_zmm(zmm);
+  evex(0x1, 0x0, 0x10, zmm, 0, base, false, kmask, zeroing);
+  mem_operand(zmm, base, disp);
+}
+
+inline void AsmEmitter::vmovups_store(unsigned char zmm, unsigned char base,
+                                      int32_t disp, unsigned char kmask) {
+  check_zmm(zmm);
+  evex(0x1, 0x0, 0x11, zmm, 0, base, false, kmask, false);
+  mem_operand(zmm, base, disp);
+}
+
+inline void AsmEmitter::broadcast_imm(unsigned char zmm, uint32_t value) {
+  check_zmm(zmm);
+  code.push_back(0xb8);  // mov eax, imm32
+  imm32(value);
+  // vpbroadcastd zmm, eax
+  evex(0x2, 0x1, 0x7c, zmm, 0, RAX, false, 0, false);
+  code.push_back(0xc0 | ((zmm & 0x7) << 3));
+}
+
+inline void AsmEmitter::kmovw_imm(unsigned char kmask, uint16_t value) {
+  if (kmask > 7) {
+    throw std::invalid_argument("invalid mask register: " +
+                                std::to_string(kmask));
+  }
+  code.push_back(0xb8);  // mov eax, imm32
+  imm32(value);
+  raw({0xc5, 0xf8, 0x92, static_cast<unsigned char>(0xc0 | (kmask << 3))});
+}
+
+inline void AsmEmitter::prefetch(unsigned char hint, unsigned char base,
+                                 int32_t disp) {
+  if (base > 7) code.push_back(0x41);  // REX.B
+  raw({0x0f, 0x18});
+  mem_operand(hint, base, disp);
+}
+
+inline index_t AsmEmitter::jmp() {
+  code.push_back(0xe9);
+  imm32(0);
+  return code.size() - 4;
+}
+
+inline index_t AsmEmitter::jcc(unsigned char condition) {
+  raw({0x0f, static_cast<unsigned char>(0x80 | (condition & 0xf))});
+  imm32(0);
+  return code.size() - 4;
+}
+
+inline void AsmEmitter::patch(index_t pos, index_t target) {
+  const int32_t rel = static_cast<int32_t>(target) -
+                      static_cast<int32_t>(pos + sizeof(int32_t));
+  std::memcpy(code.data() + pos, &rel, sizeof(rel));
+}
+
+#endif
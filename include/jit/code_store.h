@@ -16,15 +16,20 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <vector>
 
+#include "../constants/constants.h"
 #include "../log/logging.h"
+#include "../mem/arena_allocator.h"
 #include "../mem/memory.h"
 #include "../types/types.h"
+#include "asm_emitter.h"
 #include "byte_code.h"
 #include "codelet.h"
 
@@ -44,6 +49,10 @@ class CodeStore {
   std::shared_ptr<std::vector<index_t>> codelet_pos;
   size_t page_size_bytes_allocated = 0;
   void* p_addr = nullptr;
+  // number of k iterations of a 15 column tile that fit in the L1i budget
+  index_t k_block = 1;
+  // offset of the generated remainder (n % 15 columns) kernel. zero if none.
+  index_t remainder_kernel_offset = 0;
   // set and broadcast B matrix
   void set_broadcast_b_matrix(unsigned char* dest, T* constant_array,
                               size_t size);
@@ -59,6 +68,14 @@ class CodeStore {
 
   size_t get_code_size_broadcast_b_matrix(T* b_matrix, size_t num_elements);
   size_t get_code_size_gemm_b_matrix(T* b_matrix, size_t k, size_t n);
+  // generate a GEMM kernel for jelem B columns following the asm_gemm ABI
+  void generate_gemm_kernel(index_t jelem, AsmEmitter& emitter);
+  // generate the complete GEMM (tile loops, masks and strides) for a known
+  // shape. The generated function is called as void f(float* a, float* c).
+  // Returns false, leaving the emitter incomplete, if the code would exceed
+  // FUSED_GEMM_CODE_BUDGET_BYTES or the A and C offsets 32 bit displacements.
+  bool generate_fused_gemm(T* b_matrix, index_t m, index_t k, index_t n,
+                           index_t prefetch_distance, AsmEmitter& e);
   // generate instructions for B matrix
   void generate_b_matrix(T* b_matrix, size_t k, size_t n,
                          std::shared_ptr<ByteCode> bytecode);
@@ -71,6 +88,10 @@ class CodeStore {
   // read code and offset from file
   void fromfile(std::string& filename, index_t n, index_t k, index_t mode);
   std::shared_ptr<std::vector<index_t>> get_codelet_pos();
+  index_t get_k_block() const { return this->k_block; }
+  index_t get_remainder_kernel_offset() const {
+    return this->remainder_kernel_offset;
+  }
   // Copy the code from the provided vector containing unsigned char bytes to
   // a virtual page obtained by the OS. Set the appropriate permissions
   void copy_code_to_execution_space(std::shared_ptr<ByteCode> input,
@@ -171,15 +192,33 @@ void CodeStore<T>::generate_b_matrix(T* b_matrix, size_t k, size_t n,
   const index_t total_code_size = get_code_size_gemm_b_matrix(b_matrix, k, n);
   const index_t total_iterations = (ftile_j_lim / 15) * k + k + 1;
 
+  // split the code of each column tile into k segments that fit within the
+  // L1i budget. The driver streams one segment over all row tiles before
+  // moving to the next, so the segment stays resident in L1i.
+  const index_t tile_code_size = b_cols * sub_codelet_broadcast_b->size() + 1;
+  this->k_block = std::max(L1I_CODE_BUDGET_BYTES / tile_code_size,
+                           static_cast<index_t>(1));
+
+  // the remainder kernel is placed right after the B matrix code so that both
+  // share the same executable pages
+  AsmEmitter emitter;
+  if (ptile_j_remain) {
+    generate_gemm_kernel(ptile_j_remain, emitter);
+  }
+  this->remainder_kernel_offset = ptile_j_remain ? total_code_size : 0;
+
   // define a vector to store generated B matrix code until transferred
   // to page memory
-  bytecode->get_code_buffer()->resize(total_code_size);
+  bytecode->get_code_buffer()->resize(total_code_size + emitter.size());
   unsigned char* dest_ptr = bytecode->get_code_buffer()->mutable_data();
 
-  bytecode->get_offset_buffer()->resize(total_iterations);
+  bytecode->get_offset_buffer()->resize(total_iterations * sizeof(index_t));
   index_t* track = bytecode->get_offset_buffer()->mutable_data();
 
-  T* buffer = static_cast<T*>(aligned_alloc(b_cols * a_cols, sizeof(T)));
+  // scratch of a codelet row, returned to the arena when the scope ends
+  WorkspaceScope scope;
+  T* buffer = static_cast<T*>(
+      Arena::get_thread_arena().allocate(b_cols * a_cols * sizeof(T)));
   index_t tally_code_size = 0;
   index_t idx = 0;
   track[idx++] = 0;
@@ -216,7 +255,134 @@ void CodeStore<T>::generate_b_matrix(T* b_matrix, size_t k, size_t n,
         std::to_string(total_code_size) +
         " actual: " + std::to_string(tally_code_size));
   }
-  aligned_free(buffer);
+  if (emitter.size()) {
+    std::memcpy(dest_ptr + total_code_size, emitter.get_code().data(),
+                emitter.size());
+  }
+}
+
+// The generated kernel mirrors the hand written asm_gemm kernel. B values are
+// set by calling the codelet of each k iteration. ZMM2 onwards accumulate C
+// while ZMM31 downwards hold the broadcast B values.
+//
+// CALLING SEQUENCE IS AS FOLLOWS:
+//       RDI : LDA (A COLUMN STRIDE IN ELEMENTS)
+//       RSI : K
+//       RDX : LDC (C COLUMN STRIDE IN ELEMENTS)
+//       RCX : MATRIX A PTR
+//       R8  : MATRIX C PTR
+//       R9  : BASE PAGE ADDRESS
+// 0x10(EBP) : PAGE OFFSET DATA
+// 0x18(EBP) : MASK
+// 0x20(EBP) : B MATRIX IDX (CODE GEN INVOKER IDX)
+// 0x28(EBP) : ACCUMULATE (LOAD C INSTEAD OF ZEROING, K-SEGMENTED CODE)
+// 0x30(EBP) : A PREFETCH DISTANCE (NUMBER OF A COLS AHEAD)
+template <typename T>
+void CodeStore<T>::generate_gemm_kernel(index_t jelem, AsmEmitter& e) {
+  if (jelem < 1 || jelem > 15) {
+    throw std::invalid_argument("unsupported number of B columns: " +
+                                std::to_string(jelem));
+  }
+  const unsigned char acc_zmm = 2;
+  const unsigned char b_zmm = 31;
+  const unsigned char a_zmm = 0;
+
+  e.raw({
+      0x55,                    // push   rbp
+      0x48, 0x89, 0xe5,        // mov    rbp, rsp
+      0x48, 0x83, 0xec, 0x28,  // sub    rsp, 0x28
+      0x4c, 0x89, 0x45, 0xf8,  // mov    [rbp - 0x8], r8
+      0x4c, 0x89, 0x65, 0xf0,  // mov    [rbp - 0x10], r12
+      0x4c, 0x89, 0x6d, 0xe8,  // mov    [rbp - 0x18], r13
+      0x4c, 0x89, 0x75, 0xe0,  // mov    [rbp - 0x20], r14
+      0x48, 0x89, 0x55, 0xd8,  // mov    [rbp - 0x28], rdx
+      0x44, 0x0f, 0xb7, 0x5d,
+      0x18,                    // movzx  r11d, word [rbp + 0x18]
+      0xc4, 0xc1, 0x78, 0x92,
+      0xcb,                    // kmovw  k1, r11d
+      0x48, 0x83, 0x7d, 0x28,
+      0x00                     // cmp    qword [rbp + 0x28], 0x0
+  });
+  const index_t jne_loadc = e.jcc(0x5);
+  for (index_t j = 0; j < jelem; ++j) {
+    e.vxorps(acc_zmm + j);
+  }
+  const index_t jmp_initend = e.jmp();
+  e.patch(jne_loadc, e.size());
+  e.raw({
+      0x49, 0x89, 0xd2,  // mov    r10, rdx
+      0x4c, 0x89, 0xc2   // mov    rdx, r8
+  });
+  for (index_t j = 0; j < jelem; ++j) {
+    if (j) e.raw({0x4a, 0x8d, 0x14, 0x92});  // lea rdx, [rdx + r10 * 4]
+    e.vmovups_load(acc_zmm + j, RDX, 0, 1, true);
+  }
+  e.patch(jmp_initend, e.size());
+  e.raw({
+      0x31, 0xc0,              // xor    eax, eax
+      0x4c, 0x8b, 0x55, 0x20,  // mov    r10, [rbp + 0x20]
+      0x4c, 0x8b, 0x45, 0x10,  // mov    r8, [rbp + 0x10]
+      0x4c, 0x8b, 0x5d, 0x30,  // mov    r11, [rbp + 0x30]
+      0x4c, 0x0f, 0xaf, 0xdf,  // imul   r11, rdi
+      0x49, 0xc1, 0xe3, 0x02   // shl    r11, 0x2
+  });
+  // a zero prefetch distance selects a second copy of the k loop without
+  // the A prefetches
+  e.raw({0x4d, 0x85, 0xdb});  // test   r11, r11
+  const index_t jz_noprefetch = e.jcc(0x4);
+  index_t jae_exit[2];
+  for (int prefetch = 1; prefetch >= 0; --prefetch) {
+    if (!prefetch) e.patch(jz_noprefetch, e.size());
+    const index_t loop_begin = e.size();
+    e.raw({0x39, 0xf0});  // cmp    eax, esi
+    jae_exit[prefetch] = e.jcc(0x3);
+    if (prefetch) {
+      e.raw({
+          0x42, 0x0f, 0x18, 0x0c, 0x19,  // prefetcht0 [rcx + r11]
+          0x42, 0x0f, 0x18, 0x14, 0x59   // prefetcht1 [rcx + r11 * 2]
+      });
+    }
+    e.vmovups_load(a_zmm, RCX, 0, 1, false);
+    e.raw({
+        0x41, 0x89, 0xc6,        // mov    r14d, eax
+        0x4d, 0x89, 0xcd,        // mov    r13, r9
+        0x4f, 0x8d, 0x24, 0xd0,  // lea    r12, [r8 + r10 * 8]
+        0x4d, 0x8b, 0x24, 0x24,  // mov    r12, [r12]
+        0x4d, 0x01, 0xe5,        // add    r13, r12
+        0x41, 0xff, 0xd5,        // call   r13
+        0x44, 0x89, 0xf0         // mov    eax, r14d
+    });
+    for (index_t j = 0; j < jelem; ++j) {
+      e.vfmadd231ps(acc_zmm + j, b_zmm - j, a_zmm);
+    }
+    e.raw({
+        0x48, 0x8d, 0x0c, 0xb9,  // lea    rcx, [rcx + rdi * 4]
+        0x83, 0xc0, 0x01,        // add    eax, 0x1
+        0x41, 0x83, 0xc2, 0x01   // add    r10d, 0x1
+    });
+    e.patch(e.jmp(), loop_begin);
+  }
+  e.patch(jae_exit[0], e.size());
+  e.patch(jae_exit[1], e.size());
+  e.raw({
+      0x4c, 0x8b, 0x55, 0xd8,  // mov    r10, [rbp - 0x28]
+      0x48, 0x8b, 0x55, 0xf8   // mov    rdx, [rbp - 0x8]
+  });
+  for (index_t j = 0; j < jelem; ++j) {
+    if (j) e.raw({0x4a, 0x8d, 0x14, 0x92});  // lea rdx, [rdx + r10 * 4]
+    e.vmovups_store(acc_zmm + j, RDX, 0, 1);
+  }
+  e.raw({
+      0x48, 0xc7, 0xc0, 0x01,
+      0x00, 0x00, 0x00,        // mov    rax, 0x1
+      0x4c, 0x8b, 0x65, 0xf0,  // mov    r12, [rbp - 0x10]
+      0x4c, 0x8b, 0x6d, 0xe8,  // mov    r13, [rbp - 0x18]
+      0x4c, 0x8b, 0x75, 0xe0,  // mov    r14, [rbp - 0x20]
+      0x48, 0x83, 0xc4, 0x28,  // add    rsp, 0x28
+      0x48, 0x89, 0xec,        // mov    rsp, rbp
+      0x5d,                    // pop    rbp
+      0xc3                     // ret
+  });
 }
 
 template <typename T>
@@ -425,6 +591,97 @@ void CodeStore<T>::replace_zmm_bz(unsigned char* sub_codelet,
   zmm_mc[5] = 0xc0 + which_idx_in_quater * 0x9;
 }
 
+// The fused kernel inlines the B values of every (k, column) pair as
+// immediates next to the FMA that consumes them, so there is neither a call
+// per k nor any argument marshalling. A (m x k) and C (m x n) are column major
+// and every stride is baked in to the displacements. Zeros in B emit no code.
+//
+// CALLING SEQUENCE IS AS FOLLOWS:
+//       RDI : MATRIX A PTR
+//       RSI : MATRIX C PTR
+template <typename T>
+bool CodeStore<T>::generate_fused_gemm(T* b_matrix, index_t m, index_t k,
+                                       index_t n, index_t prefetch_distance,
+                                       AsmEmitter& e) {
+  const index_t b_cols = 15;
+  const unsigned char acc_zmm = 2;
+  const unsigned char b_zmm = 31;
+  const unsigned char a_zmm = 0;
+  const unsigned char full_mask = 1;
+  const unsigned char partial_mask = 2;
+  const index_t full_row_tiles = m / 16;
+  const index_t col_bytes = m * sizeof(T);
+  // A columns (including the prefetch look ahead) and C columns are
+  // addressed with 32 bit displacements from the tile base
+  const index_t max_disp = std::numeric_limits<int32_t>::max();
+  if ((k + prefetch_distance) * col_bytes > max_disp ||
+      n * col_bytes > max_disp) {
+    return false;
+  }
+  auto disp = [](index_t bytes) { return static_cast<int32_t>(bytes); };
+
+  e.kmovw_imm(full_mask, 0xffff);
+  e.kmovw_imm(partial_mask, ~(0xffff << (m & 0xf)));
+
+  // one 16 row tile of C for the columns [jj, jj + jelem)
+  auto tile = [&](index_t jj, index_t jelem, unsigned char kmask) {
+    for (index_t j = 0; j < jelem; ++j) {
+      e.vxorps(acc_zmm + j);
+    }
+    for (index_t kk = 0; kk < k; ++kk) {
+      const T* b_row = b_matrix + kk * n + jj;
+      bool is_zero_row = true;
+      for (index_t j = 0; j < jelem; ++j) {
+        if (b_row[j] != 0) is_zero_row = false;
+      }
+      if (is_zero_row) continue;
+      if (prefetch_distance && full_row_tiles) {
+        e.prefetch(0x1, RCX, disp((kk + prefetch_distance) * col_bytes));
+      }
+      e.vmovups_load(a_zmm, RCX, disp(kk * col_bytes), kmask, true);
+      for (index_t j = 0; j < jelem; ++j) {
+        if (b_row[j] == 0) continue;
+        uint32_t value;
+        std::memcpy(&value, b_row + j, sizeof(value));
+        e.broadcast_imm(b_zmm - j, value);
+        e.vfmadd231ps(acc_zmm + j, b_zmm - j, a_zmm);
+      }
+    }
+    for (index_t j = 0; j < jelem; ++j) {
+      e.vmovups_store(acc_zmm + j, RDX, disp((jj + j) * col_bytes), kmask);
+    }
+  };
+
+  for (index_t jj = 0; jj < n; jj += b_cols) {
+    const index_t jelem = std::min(b_cols, n - jj);
+    e.raw({
+        0x48, 0x89, 0xf9,  // mov    rcx, rdi
+        0x48, 0x89, 0xf2   // mov    rdx, rsi
+    });
+    if (full_row_tiles) {
+      e.raw({0x41, 0xb8});  // mov    r8d, imm32
+      e.imm32(static_cast<uint32_t>(full_row_tiles));
+      const index_t loop_begin = e.size();
+      tile(jj, jelem, full_mask);
+      e.raw({
+          0x48, 0x83, 0xc1, 0x40,  // add    rcx, 0x40
+          0x48, 0x83, 0xc2, 0x40,  // add    rdx, 0x40
+          0x41, 0xff, 0xc8         // dec    r8d
+      });
+      e.patch(e.jcc(0x5), loop_begin);  // jnz
+    }
+    if (m & 0xf) {
+      tile(jj, jelem, partial_mask);
+    }
+    // the code grows with k * n, stop once the budget is exceeded
+    if (e.size() >= FUSED_GEMM_CODE_BUDGET_BYTES) {
+      return false;
+    }
+  }
+  e.raw({0xc3});  // ret
+  return true;
+}
+
 // write generated code to the specified filename
 template <typename T>
 void CodeStore<T>::tofile(
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __COMPILED_GEMM_H_
+#define __COMPILED_GEMM_H_
+
+#include <type_traits>
+
+#include "../types/types.h"
+
+// signature of the generated GEMM kernels (identical to asm_gemm). lda and ldc
+// are the column strides of the column major A and C tiles.
+typedef index_t (*gemm_kernel_t)(index_t lda, index_t k, index_t ldc, float* a,
+                                 float* c, void* p_addr, index_t* offset_data,
+                                 uint16_t mask, index_t idx, index_t accumulate,
+                                 index_t prefetch_distance);
+
+// signature of the shape specialized whole GEMM kernel
+typedef void (*fused_gemm_t)(float* a, float* c);
+
+// CompiledGemm is an immutable, non-owning view of the code generated by a
+// Jitter. It holds plain pointers to the executable pages and the offset
+// table, so it can be copied by value and shared across threads without any
+// reference counting. The generated kernels only read the code and offsets
+// and keep their state in registers and on the stack, which makes concurrent
+// calls safe. The handle is valid as long as the Jitter that produced it is
+// alive and has not regenerated its code.
+struct CompiledGemm {
+  void* p_addr;
+  index_t* offset_data;
+  gemm_kernel_t remainder_kernel;
+  fused_gemm_t fused_kernel;
+  index_t k;
+  index_t n;
+  index_t k_block;
+  index_t fused_m;
+  index_t prefetch_distance;
+  bool is_prefetch_distance_set;
+
+  // row masks are derived per call from m
+  static uint16_t get_mask() { return 0xffff; }
+  static uint16_t get_pmask(index_t m) { return ~(0xffff << (m & 0xf)); }
+  // fused kernel if the code was specialized for (m, k, n), else nullptr
+  fused_gemm_t get_fused_kernel(index_t m, index_t k, index_t n) const {
+    return fused_kernel != nullptr && m == fused_m && k == this->k &&
+                   n == this->n
+               ? fused_kernel
+               : nullptr;
+  }
+  // A prefetch distance used for a GEMM with m rows. Unless overridden, a 16
+  // row A tile spans at most a cache line per column which the hardware
+  // prefetcher already follows, so the look ahead is only used for m > 16.
+  index_t get_prefetch_distance(index_t m) const {
+    if (is_prefetch_distance_set) return prefetch_distance;
+    return m > 16 ? prefetch_distance : 0;
+  }
+};
+
+static_assert(std::is_trivially_copyable<CompiledGemm>::value,
+              "CompiledGemm must be trivially copyable");
+
+#endif
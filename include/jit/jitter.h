@@ -11,11 +11,13 @@
 #ifndef __JITTER_H_
 #define __JITTER_H_
 
+#include "../constants/constants.h"
 #include "../mem/allocator.h"
 #include "../mem/buffer.h"
 #include "byte_code.h"
 #include "code_store.h"
 #include "codelet.h"
+#include "compiled_gemm.h"
 
 // Jitter issues code generation directives and retains pointers to the base
 // page address and also the total page size. By destroying the Jitter,
@@ -33,14 +35,22 @@ class Jitter {
   std::shared_ptr<Codelet> codelet;
   bool is_buffer_owner;
   bool is_store_owner;
-  void* p_addr;
+  void* p_addr = nullptr;
   size_t page_size_bytes;
-  index_t* offset_data;
+  index_t* offset_data = nullptr;
   std::string name;
   uint32_t* arr_a_offsets;
   uint32_t* arr_c_offsets;
-  uint16_t mask;
-  uint16_t pmask;
+  index_t k_block = 1;
+  gemm_kernel_t remainder_kernel = nullptr;
+  // shape specialized whole GEMM (see generate_fused_code)
+  std::shared_ptr<Codelet> fused_codelet;
+  fused_gemm_t fused_kernel = nullptr;
+  index_t fused_m = 0;
+  index_t k = 0;
+  index_t n = 0;
+  index_t prefetch_distance = A_PREFETCH_DISTANCE;
+  bool is_prefetch_distance_set = false;
 
  public:
   Jitter(std::shared_ptr<IAllocator<unsigned char>> code_alloc,
@@ -74,14 +84,42 @@ class Jitter {
   explicit Jitter()
       : Jitter(GetCPUAllocator<unsigned char>(), GetCPUAllocator<index_t>()){};
   ~Jitter();
+  // generate the B matrix code. The code does not depend on the number of
+  // rows of A, so one jitter serves any m (e.g. a changing batch size).
+  void generate_code(T* matrix, int k, int n);
   void generate_code(T* matrix, int m, int k, int n);
+  // in addition to the B matrix code, generate a single function computing
+  // the complete GEMM for exactly (m, k, n). Intended for fixed shape layers
+  // with small matrices where the driver overhead dominates. Shapes whose
+  // code exceeds FUSED_GEMM_CODE_BUDGET_BYTES get no fused kernel and sgemm
+  // uses the k-segmented code.
+  void generate_fused_code(T* matrix, int m, int k, int n);
   void execute(index_t idx);
-  void* get_p_addr() { return this->p_addr; }
-  index_t* get_offset_data() { return this->offset_data; }
-  uint32_t* get_a_offsets() { return this->arr_a_offsets; }
-  uint32_t* get_c_offsets() { return this->arr_c_offsets; }
-  uint16_t get_mask() { return this->mask; }
-  uint16_t get_pmask() { return this->pmask; }
+  void* get_p_addr() const { return this->p_addr; }
+  index_t* get_offset_data() const { return this->offset_data; }
+  uint32_t* get_a_offsets() const { return this->arr_a_offsets; }
+  uint32_t* get_c_offsets() const { return this->arr_c_offsets; }
+  // row masks are derived per call from m and never stored in the jitter
+  static uint16_t get_mask() { return CompiledGemm::get_mask(); }
+  static uint16_t get_pmask(index_t m) { return CompiledGemm::get_pmask(m); }
+  index_t get_k_block() const { return this->k_block; }
+  // kernel generated for the n % 15 remainder columns (nullptr if none)
+  gemm_kernel_t get_remainder_kernel() const { return this->remainder_kernel; }
+  fused_gemm_t get_fused_kernel(index_t m, index_t k, index_t n) const {
+    return this->get_compiled().get_fused_kernel(m, k, n);
+  }
+  index_t get_prefetch_distance(index_t m) const {
+    return this->get_compiled().get_prefetch_distance(m);
+  }
+  // immutable, trivially copyable handle to the generated code. Prefer
+  // passing it to sgemm over the shared Jitter when calling from many threads.
+  CompiledGemm get_compiled() const;
+  // override the A prefetch distance (in A columns) chosen for the shape.
+  // Setting 0 disables the look ahead. Tune per CPU using the benchmarks.
+  void set_prefetch_distance(index_t distance) {
+    this->prefetch_distance = distance;
+    this->is_prefetch_distance_set = true;
+  }
 };
 
 template <typename T>
@@ -96,6 +134,11 @@ Jitter<T>::~Jitter() {
 
 template <typename T>
 void Jitter<T>::generate_code(T* matrix, int m, int k, int n) {
+  this->generate_code(matrix, k, n);
+}
+
+template <typename T>
+void Jitter<T>::generate_code(T* matrix, int k, int n) {
   if (this->code_buffer == nullptr) {
     this->code_buffer =
         std::make_shared<Buffer<unsigned char>>(this->code_alloc);
@@ -115,8 +158,57 @@ void Jitter<T>::generate_code(T* matrix, int m, int k, int n) {
   this->p_addr = codelet->get_p_addr();
   this->page_size_bytes = codelet->get_page_size_bytes();
   this->offset_data = this->bytecode->get_offset_buffer()->mutable_data();
-  this->mask = 0xffff;
-  this->pmask = ~(0xffff << (m & 0xf));
+  this->k_block = store->get_k_block();
+  this->fused_kernel = nullptr;
+  this->fused_codelet = nullptr;
+  this->fused_m = 0;
+  this->k = k;
+  this->n = n;
+  this->remainder_kernel =
+      store->get_remainder_kernel_offset()
+          ? reinterpret_cast<gemm_kernel_t>(
+                static_cast<unsigned char*>(this->p_addr) +
+                store->get_remainder_kernel_offset())
+          : nullptr;
+}
+
+template <typename T>
+void Jitter<T>::generate_fused_code(T* matrix, int m, int k, int n) {
+  this->generate_code(matrix, m, k, n);
+  AsmEmitter emitter;
+  if (!store->generate_fused_gemm(matrix, m, k, n,
+                                  this->get_prefetch_distance(m), emitter)) {
+    return;
+  }
+  std::shared_ptr<IBuffer<unsigned char>> fused_buffer =
+      std::make_shared<Buffer<unsigned char>>(
+          GetCPUAllocator<unsigned char>());
+  fused_buffer->resize(emitter.size());
+  fused_buffer->copy(const_cast<unsigned char*>(emitter.get_code().data()), 0,
+                     emitter.size());
+  this->fused_codelet = std::make_shared<Codelet>();
+  store->copy_code_to_execution_space(
+      std::make_shared<ByteCode>(fused_buffer, this->offset_buffer),
+      this->fused_codelet);
+  this->fused_kernel =
+      reinterpret_cast<fused_gemm_t>(this->fused_codelet->get_p_addr());
+  this->fused_m = m;
+}
+
+template <typename T>
+CompiledGemm Jitter<T>::get_compiled() const {
+  CompiledGemm compiled;
+  compiled.p_addr = this->p_addr;
+  compiled.offset_data = this->offset_data;
+  compiled.remainder_kernel = this->remainder_kernel;
+  compiled.fused_kernel = this->fused_kernel;
+  compiled.k = this->k;
+  compiled.n = this->n;
+  compiled.k_block = this->k_block;
+  compiled.fused_m = this->fused_m;
+  compiled.prefetch_distance = this->prefetch_distance;
+  compiled.is_prefetch_distance_set = this->is_prefetch_distance_set;
+  return compiled;
 }
 
 template <typename T>
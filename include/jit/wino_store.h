@@ -11,8 +11,10 @@
 #ifndef __WINO_STORE_H__
 #define __WINO_STORE_H__
 
+#include "constants/constants.h"
 #include "jit/code_store.h"
 #include "log/logging.h"
+#include "mem/arena_allocator.h"
 #include "mem/memory.h"
 #include "types/types.h"
 
@@ -47,8 +49,14 @@ const size_t WinoStore<T>::get_code_size_b_tensor(const T* b_tensor,
   const size_t sc_size = this->sub_codelet_broadcast_b->size();
   const size_t sc_z_size = this->sub_codelet_broadcast_bz->size();
 
+  if (in_tile_area % WINO_POSITIONS_PER_ROUND != 0) {
+    throw std::invalid_argument(
+        "tile area must be a multiple of " +
+        std::to_string(WINO_POSITIONS_PER_ROUND) +
+        ", found: " + std::to_string(in_tile_area));
+  }
   size_t num_zeros = 0;
-  for (index_t i = 0; i < 16 * in_channels * out_channels; ++i) {
+  for (index_t i = 0; i < in_tile_area * in_channels * out_channels; ++i) {
     if (b_tensor[i] == 0) num_zeros++;
   }
 
@@ -56,8 +64,9 @@ const size_t WinoStore<T>::get_code_size_b_tensor(const T* b_tensor,
   LOG_DEBUG("sub codelet bz size: " + std::to_string(sc_z_size));
   LOG_DEBUG("number of zeros in B: " + std::to_string(num_zeros));
 
-  const index_t num_rounds = 2;
-  const index_t elements_per_tile = in_tile_area / num_rounds;
+  // every codelet broadcasts the positions of one multiply round
+  const index_t elements_per_tile = WINO_POSITIONS_PER_ROUND;
+  const index_t num_rounds = in_tile_area / elements_per_tile;
   const index_t num_tiles = num_rounds * in_channels * out_channels;
   const index_t tile_code = (elements_per_tile * sc_size + 1) * num_tiles;
 
@@ -73,13 +82,8 @@ void WinoStore<T>::generate_b_tensor(const T* b_tensor,
                                      const size_t in_channels,
                                      const size_t out_channels,
                                      std::shared_ptr<ByteCode> bytecode) {
-  size_t num_zeros = 0;
-  for (index_t i = 0; i < in_channels * out_channels; ++i) {
-    if (b_tensor[i] == 0) num_zeros++;
-  }
-
-  const index_t num_rounds = 2;
-  const index_t elements_per_tile = in_tile_area / num_rounds;
+  const index_t elements_per_tile = WINO_POSITIONS_PER_ROUND;
+  const index_t num_rounds = in_tile_area / elements_per_tile;
   const index_t b_stride = in_channels * out_channels;
   const index_t total_code_size =
       get_code_size_b_tensor(b_tensor, in_tile_area, in_channels, out_channels);
@@ -90,10 +94,15 @@ void WinoStore<T>::generate_b_tensor(const T* b_tensor,
   bytecode->get_code_buffer()->resize(total_code_size);
   unsigned char* dest_ptr = bytecode->get_code_buffer()->mutable_data();
 
-  bytecode->get_offset_buffer()->resize(total_iterations);
+  // codelet start offsets followed by the end of the last codelet
+  bytecode->get_offset_buffer()->resize((total_iterations + 1) *
+                                        sizeof(index_t));
   index_t* track = bytecode->get_offset_buffer()->mutable_data();
 
-  T* buffer = static_cast<T*>(aligned_alloc(elements_per_tile, sizeof(T)));
+  // scratch of a codelet tile, returned to the arena when the scope ends
+  WorkspaceScope scope;
+  T* buffer = static_cast<T*>(
+      Arena::get_thread_arena().allocate(elements_per_tile * sizeof(T)));
   index_t tally_code_size = 0;
   index_t idx = 0;
   track[idx++] = 0;
@@ -121,6 +130,5 @@ void WinoStore<T>::generate_b_tensor(const T* b_tensor,
         std::to_string(total_code_size) +
         " actual: " + std::to_string(tally_code_size));
   }
-  aligned_free(buffer);
 }
 #endif
\ No newline at end of file
@@ -13,6 +13,10 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
+#include <cstdint>
+
+#include "../constants/constants.h"
 #include "../types/types.h"
 
 template <typename T>
@@ -39,4 +43,155 @@ void transpose4x4(T* src, T* dst, index_t height, index_t width) {
   _mm_store_ps(dst + 0xc, m3);
 }
 
+// Transposes the 16x16 single precision block held in the registers r (one
+// row per register) such that r[i] holds column i afterwards. Uses the
+// unpack / shuffle / 128 bit lane shuffle sequence (64 shuffles in total).
+inline void transpose16x16(__m512 r[16]) {
+  __m512 t[16];
+  for (index_t i = 0; i < 16; i += 2) {
+    t[i] = _mm512_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm512_unpackhi_ps(r[i], r[i + 1]);
+  }
+  for (index_t i = 0; i < 16; i += 4) {
+    r[i] = _mm512_shuffle_ps(t[i], t[i + 2], 0x44);
+    r[i + 1] = _mm512_shuffle_ps(t[i], t[i + 2], 0xee);
+    r[i + 2] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+    r[i + 3] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0xee);
+  }
+  for (index_t i = 0; i < 16; i += 8) {
+    for (index_t j = 0; j < 4; ++j) {
+      t[i + j] = _mm512_shuffle_f32x4(r[i + j], r[i + j + 4], 0x88);
+      t[i + j + 4] = _mm512_shuffle_f32x4(r[i + j], r[i + j + 4], 0xdd);
+    }
+  }
+  for (index_t j = 0; j < 8; ++j) {
+    r[j] = _mm512_shuffle_f32x4(t[j], t[j + 8], 0x88);
+    r[j + 8] = _mm512_shuffle_f32x4(t[j], t[j + 8], 0xdd);
+  }
+}
+
+// Loads a rows x cols (<= 16 x 16) block of src (leading dimension ld) in to
+// the registers r, one row per register. Elements outside of the block are
+// zero and never accessed.
+inline void load_block16(const float* src, index_t rows, index_t cols,
+                         index_t ld, __m512 r[16]) {
+  const __mmask16 cmask = static_cast<__mmask16>(~(0xffffffff << cols));
+  for (index_t i = 0; i < 16; ++i) {
+    r[i] = i < rows ? _mm512_maskz_loadu_ps(cmask, src + i * ld)
+                    : _mm512_setzero_ps();
+  }
+}
+
+// Stores the first rows x cols (<= 16 x 16) elements of the registers r to dst
+// (leading dimension ld). Streaming stores bypass the caches for full rows at
+// 64 byte aligned addresses and the caller issues the store fence.
+template <bool Stream = false>
+inline void store_block16(float* dst, index_t rows, index_t cols, index_t ld,
+                          const __m512 r[16]) {
+  const __mmask16 cmask = static_cast<__mmask16>(~(0xffffffff << cols));
+  for (index_t i = 0; i < rows; ++i) {
+    float* row = dst + i * ld;
+    if (Stream && cols == 16 &&
+        (reinterpret_cast<uintptr_t>(row) & (ALIGN_BYTE_SIZE - 1)) == 0) {
+      _mm512_stream_ps(row, r[i]);
+    } else {
+      _mm512_mask_storeu_ps(row, cmask, r[i]);
+    }
+  }
+}
+
+// Transposes one rows x cols tile of src (at most TRANSPOSE_BLOCK_SIZE in each
+// dimension) in to dst, one 16x16 register block at a time.
+template <bool Stream = false>
+inline void transpose_tile(const float* src, index_t rows, index_t cols,
+                           index_t ld_src, float* dst, index_t ld_dst) {
+  __m512 r[16];
+  for (index_t i = 0; i < rows; i += 16) {
+    const index_t ielem = std::min<index_t>(16, rows - i);
+    for (index_t j = 0; j < cols; j += 16) {
+      const index_t jelem = std::min<index_t>(16, cols - j);
+      load_block16(src + i * ld_src + j, ielem, jelem, ld_src, r);
+      transpose16x16(r);
+      store_block16<Stream>(dst + j * ld_dst + i, jelem, ielem, ld_dst, r);
+    }
+  }
+}
+
+// Transposes the rows x cols matrix src (leading dimension ld_src) in to dst
+// (leading dimension ld_dst). The matrix is visited in cache sized tiles of
+// 16x16 register blocks. Edge blocks use masked loads and stores, hence no
+// element outside either matrix is accessed. Stream selects non-temporal
+// stores for outputs that do not fit in the caches.
+template <bool Stream = false>
+inline void transpose_blocked(const float* src, index_t rows, index_t cols,
+                              index_t ld_src, float* dst, index_t ld_dst) {
+  for (index_t i = 0; i < rows; i += TRANSPOSE_BLOCK_SIZE) {
+    const index_t ielem = std::min(TRANSPOSE_BLOCK_SIZE, rows - i);
+    for (index_t j = 0; j < cols; j += TRANSPOSE_BLOCK_SIZE) {
+      const index_t jelem = std::min(TRANSPOSE_BLOCK_SIZE, cols - j);
+      transpose_tile<Stream>(src + i * ld_src + j, ielem, jelem, ld_src,
+                             dst + j * ld_dst + i, ld_dst);
+    }
+  }
+  if (Stream) {
+    _mm_sfence();
+  }
+}
+
+// OpenMP variant of transpose_blocked. Tiles are distributed statically over
+// the threads of the team.
+template <bool Stream = false>
+inline void transpose_parallel(const float* src, index_t rows, index_t cols,
+                               index_t ld_src, float* dst, index_t ld_dst) {
+  const index_t row_tiles =
+      (rows + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+  const index_t col_tiles =
+      (cols + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel
+  {
+#pragma omp for collapse(2) schedule(static)
+    for (index_t ti = 0; ti < row_tiles; ++ti) {
+      for (index_t tj = 0; tj < col_tiles; ++tj) {
+        const index_t i = ti * TRANSPOSE_BLOCK_SIZE;
+        const index_t j = tj * TRANSPOSE_BLOCK_SIZE;
+        transpose_tile<Stream>(src + i * ld_src + j,
+                               std::min(TRANSPOSE_BLOCK_SIZE, rows - i),
+                               std::min(TRANSPOSE_BLOCK_SIZE, cols - j),
+                               ld_src, dst + j * ld_dst + i, ld_dst);
+      }
+    }
+    // streaming stores are ordered per thread
+    if (Stream) {
+      _mm_sfence();
+    }
+  }
+}
+
+// Transposes the n x n matrix mat (leading dimension ld) in place. Blocks on
+// the diagonal are transposed in registers and the off diagonal block pairs
+// (i, j) / (j, i) are swapped while transposed, hence no scratch memory is
+// used.
+inline void transpose_inplace(float* mat, index_t n, index_t ld) {
+  __m512 r[16];
+  __m512 s[16];
+  for (index_t i = 0; i < n; i += 16) {
+    const index_t ielem = std::min<index_t>(16, n - i);
+    float* diag = mat + i * ld + i;
+    load_block16(diag, ielem, ielem, ld, r);
+    transpose16x16(r);
+    store_block16(diag, ielem, ielem, ld, r);
+    for (index_t j = i + 16; j < n; j += 16) {
+      const index_t jelem = std::min<index_t>(16, n - j);
+      float* upper = mat + i * ld + j;
+      float* lower = mat + j * ld + i;
+      load_block16(upper, ielem, jelem, ld, r);
+      load_block16(lower, jelem, ielem, ld, s);
+      transpose16x16(r);
+      transpose16x16(s);
+      store_block16(lower, jelem, ielem, ld, r);
+      store_block16(upper, ielem, jelem, ld, s);
+    }
+  }
+}
+
 #endif
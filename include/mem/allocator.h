@@ -11,11 +11,18 @@
 #ifndef __MEM_MANAGER_H__
 #define __MEM_MANAGER_H__
 
+#include <string.h>
+
+#include <algorithm>
 #include <iostream>
+#include <new>
 #include <vector>
 
 #include "allocator_interface.h"
+#include "arena_allocator.h"
+#include "huge_page_allocator.h"
 #include "log/logging.h"
+#include "numa_allocator.h"
 
 template <typename T>
 class Allocator : public IAllocator<T> {
@@ -75,12 +82,22 @@ void* Allocator<T>::resize(void* base_ptr, size_t size) {
   index_t offset = ALIGN_SIZE - 1 + sizeof(void*);
   index_t total_size = size * sizeof(T) + offset;
   void* original_ptr = reinterpret_cast<void**>(base_ptr)[-1];
+  const size_t old_offset = reinterpret_cast<size_t>(base_ptr) -
+                            reinterpret_cast<size_t>(original_ptr);
   void* ptr = std::realloc(original_ptr, total_size);
   if (ptr == nullptr) {
-    return reinterpret_cast<void*>(base_ptr);
+    throw std::bad_alloc();
   }
   void** aligned_ptr = reinterpret_cast<void**>(
       (reinterpret_cast<size_t>(ptr) + offset) & ~(ALIGN_SIZE - 1));
+  const size_t new_offset =
+      reinterpret_cast<size_t>(aligned_ptr) - reinterpret_cast<size_t>(ptr);
+  // realloc preserves the bytes relative to the block, hence the data is
+  // shifted when the block moved to an address with a different alignment
+  if (new_offset != old_offset) {
+    memmove(aligned_ptr, static_cast<unsigned char*>(ptr) + old_offset,
+            total_size - std::max(old_offset, new_offset));
+  }
   aligned_ptr[-1] = ptr;
   return reinterpret_cast<T*>(aligned_ptr);
 }
@@ -98,4 +115,20 @@ std::shared_ptr<IAllocator<T>> GetCPUAllocator() {
   return allocator;
 }
 
+// returns the shared allocator of the given kind
+template <typename T>
+std::shared_ptr<IAllocator<T>> GetAllocator(allocator_t kind) {
+  switch (kind) {
+    case ARENA_ALLOCATOR:
+      return GetArenaAllocator<T>();
+    case HUGE_PAGE_ALLOCATOR:
+      return GetHugePageAllocator<T>();
+    case NUMA_ALLOCATOR:
+      return GetNumaAllocator<T>();
+    case CPU_ALLOCATOR:
+    default:
+      return GetCPUAllocator<T>();
+  }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,414 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __ARENA_ALLOCATOR_H__
+#define __ARENA_ALLOCATOR_H__
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "../constants/constants.h"
+#include "allocator_interface.h"
+#include "memory.h"
+
+// Arena is a per thread bump allocator. Blocks are carved out of large chunks
+// and rounded up to power of two size classes (64 bytes upwards). Freed blocks
+// are kept in per size class free lists and handed out again, hence repeated
+// temporaries of the same size never reach the heap. WorkspaceScope rewinds
+// the bump pointer, releasing every block allocated within the scope at once.
+// Within a scope only free blocks past the scope mark are reused, hence every
+// scoped block is reclaimed by the release. Unscoped blocks (ArenaAllocator)
+// are owned until freed: a release never rewinds the bump pointer below a
+// live unscoped block.
+//
+// Every block records the arena it was carved from. Blocks freed by another
+// thread are queued on the owning arena and recycled by its thread on the next
+// allocation. The arena of an exiting thread is retired: its chunks stay alive
+// until the last of its blocks still held elsewhere is freed.
+class Arena {
+ public:
+  // position of the bump pointer
+  struct Mark {
+    index_t chunk;
+    index_t offset;
+  };
+
+ private:
+  struct Chunk {
+    unsigned char* base;
+    index_t size;
+    // bytes handed out by the bump pointer before it moved to the next chunk
+    index_t used;
+  };
+  // stored in the ALIGN_BYTE_SIZE bytes preceding each block
+  struct BlockHeader {
+    index_t size_class;
+    Mark position;
+    Arena* owner;
+    bool live;
+    // released by WorkspaceScope (else only by free)
+    bool scoped;
+  };
+  static_assert(sizeof(BlockHeader) <= ALIGN_BYTE_SIZE,
+                "block header exceeds the block alignment");
+  // destroys the arena of the thread once the thread exits
+  struct ThreadArena {
+    Arena* arena = nullptr;
+    ~ThreadArena() {
+      if (arena != nullptr) arena->retire();
+      arena = nullptr;
+    }
+  };
+  static const index_t NUM_SIZE_CLASSES = 40;
+  std::vector<Chunk> chunks;
+  Mark top = {0, 0};
+  // mark of the innermost WorkspaceScope
+  Mark scope_mark = {0, 0};
+  std::vector<void*> free_lists[NUM_SIZE_CLASSES];
+  // blocks handed out and neither freed nor released
+  index_t live_blocks = 0;
+  // blocks freed by other threads, guarded by remote_mutex
+  std::mutex remote_mutex;
+  std::vector<void*> remote_frees;
+  std::atomic<bool> has_remote_frees{false};
+  bool retired = false;
+  static index_t get_size_class(index_t bytes);
+  static BlockHeader* get_header(void* ptr);
+  static ThreadArena& get_thread_holder();
+  static bool is_before(const Mark& a, const Mark& b) {
+    return a.chunk < b.chunk || (a.chunk == b.chunk && a.offset < b.offset);
+  }
+  // moves the bump pointer to a chunk with at least bytes available
+  void next_chunk(index_t bytes);
+  // returns a block to the free lists of this arena (owning thread only)
+  void recycle(void* ptr);
+  // recycles the blocks other threads freed
+  void drain_remote_frees();
+  // called once the owning thread exits
+  void retire();
+  friend class WorkspaceScope;
+
+ public:
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  ~Arena();
+  // returns an ALIGN_BYTE_SIZE aligned block of at least bytes bytes. Unscoped
+  // blocks survive the release of the enclosing scopes and must be freed.
+  void* allocate(index_t bytes, bool scoped = true);
+  // frees a block of any arena, on any thread
+  void free(void* ptr);
+  // number of bytes usable in the block
+  index_t get_block_size(void* ptr) const;
+  Mark mark() const { return top; }
+  // releases all blocks allocated after the mark
+  void release(const Mark& mark);
+  // total number of bytes held by the chunks
+  index_t get_reserved_bytes() const;
+  static Arena& get_thread_arena();
+};
+
+inline Arena::~Arena() {
+  for (Chunk& chunk : chunks) {
+    aligned_free(chunk.base);
+  }
+}
+
+inline index_t Arena::get_size_class(index_t bytes) {
+  index_t size_class = 0;
+  while ((ALIGN_BYTE_SIZE << size_class) < bytes) {
+    ++size_class;
+  }
+  if (size_class >= NUM_SIZE_CLASSES) {
+    throw std::bad_alloc();
+  }
+  return size_class;
+}
+
+inline Arena::BlockHeader* Arena::get_header(void* ptr) {
+  return reinterpret_cast<BlockHeader*>(static_cast<unsigned char*>(ptr) -
+                                        ALIGN_BYTE_SIZE);
+}
+
+inline void Arena::next_chunk(index_t bytes) {
+  if (!chunks.empty()) {
+    chunks[top.chunk].used = top.offset;
+  }
+  const index_t next = chunks.empty() ? 0 : top.chunk + 1;
+  // retained chunks that are too small are replaced
+  if (next < chunks.size() && chunks[next].size < bytes) {
+    aligned_free(chunks[next].base);
+    chunks.erase(chunks.begin() + next);
+  }
+  if (next == chunks.size() || chunks[next].size < bytes) {
+    const index_t size = std::max(ARENA_CHUNK_BYTES, bytes);
+    Chunk chunk = {static_cast<unsigned char*>(aligned_alloc(size, 1)), size,
+                   0};
+    chunks.insert(chunks.begin() + next, chunk);
+  }
+  top = {next, 0};
+}
+
+inline void* Arena::allocate(index_t bytes, bool scoped) {
+  if (has_remote_frees.load(std::memory_order_acquire)) {
+    drain_remote_frees();
+  }
+  const index_t size_class = get_size_class(bytes);
+  std::vector<void*>& free_list = free_lists[size_class];
+  // a scoped block before the scope mark would escape the release
+  for (index_t i = free_list.size(); i > 0; --i) {
+    void* ptr = free_list[i - 1];
+    BlockHeader* header = get_header(ptr);
+    if (scoped && is_before(header->position, scope_mark)) continue;
+    free_list.erase(free_list.begin() + (i - 1));
+    header->live = true;
+    header->scoped = scoped;
+    ++live_blocks;
+    return ptr;
+  }
+  const index_t block_bytes = ALIGN_BYTE_SIZE + (ALIGN_BYTE_SIZE << size_class);
+  if (chunks.empty() || top.offset + block_bytes > chunks[top.chunk].size) {
+    next_chunk(block_bytes);
+  }
+  unsigned char* block = chunks[top.chunk].base + top.offset;
+  BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+  header->size_class = size_class;
+  header->position = top;
+  header->owner = this;
+  header->live = true;
+  header->scoped = scoped;
+  top.offset += block_bytes;
+  ++live_blocks;
+  return block + ALIGN_BYTE_SIZE;
+}
+
+inline void Arena::recycle(void* ptr) {
+  BlockHeader* header = get_header(ptr);
+  // blocks dropped by release belong to the bump pointer again
+  if (!header->live) return;
+  header->live = false;
+  --live_blocks;
+  free_lists[header->size_class].push_back(ptr);
+}
+
+inline void Arena::drain_remote_frees() {
+  std::vector<void*> frees;
+  {
+    std::lock_guard<std::mutex> lock(remote_mutex);
+    frees.swap(remote_frees);
+    has_remote_frees.store(false, std::memory_order_release);
+  }
+  for (void* ptr : frees) {
+    recycle(ptr);
+  }
+}
+
+inline void Arena::free(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Arena* owner = get_header(ptr)->owner;
+  if (owner == get_thread_holder().arena) {
+    owner->recycle(ptr);
+    return;
+  }
+  bool destroy = false;
+  {
+    std::lock_guard<std::mutex> lock(owner->remote_mutex);
+    if (owner->retired) {
+      // the owning thread is gone, the chunks live until the last block
+      BlockHeader* header = get_header(ptr);
+      if (header->live) {
+        header->live = false;
+        destroy = --owner->live_blocks == 0;
+      }
+    } else {
+      owner->remote_frees.push_back(ptr);
+      owner->has_remote_frees.store(true, std::memory_order_release);
+    }
+  }
+  if (destroy) {
+    delete owner;
+  }
+}
+
+inline index_t Arena::get_block_size(void* ptr) const {
+  return ALIGN_BYTE_SIZE << get_header(ptr)->size_class;
+}
+
+inline void Arena::release(const Mark& mark) {
+  if (has_remote_frees.load(std::memory_order_acquire)) {
+    drain_remote_frees();
+  }
+  // scoped blocks beyond the mark which are still held are dropped. The bump
+  // pointer is rewound to the mark or past the last live unscoped block.
+  Mark end_of_kept = mark;
+  std::vector<void*> dropped;
+  for (index_t c = mark.chunk; c <= top.chunk && c < chunks.size(); ++c) {
+    const index_t end = c == top.chunk ? top.offset : chunks[c].used;
+    index_t offset = c == mark.chunk ? mark.offset : 0;
+    while (offset < end) {
+      BlockHeader* header =
+          reinterpret_cast<BlockHeader*>(chunks[c].base + offset);
+      const index_t block_bytes =
+          ALIGN_BYTE_SIZE + (ALIGN_BYTE_SIZE << header->size_class);
+      if (header->live && !header->scoped) {
+        end_of_kept = {c, offset + block_bytes};
+      } else {
+        if (header->live) {
+          header->live = false;
+          --live_blocks;
+        }
+        dropped.push_back(chunks[c].base + offset + ALIGN_BYTE_SIZE);
+      }
+      offset += block_bytes;
+    }
+  }
+  top = end_of_kept;
+  // free blocks beyond the mark are rebuilt from the walk: those before the
+  // new top are reused through the free lists, the others by the bump pointer
+  auto is_released = [&mark](void* ptr) {
+    return !is_before(get_header(ptr)->position, mark);
+  };
+  for (std::vector<void*>& free_list : free_lists) {
+    free_list.erase(
+        std::remove_if(free_list.begin(), free_list.end(), is_released),
+        free_list.end());
+  }
+  for (void* ptr : dropped) {
+    BlockHeader* header = get_header(ptr);
+    if (is_before(header->position, top)) {
+      free_lists[header->size_class].push_back(ptr);
+    }
+  }
+}
+
+inline void Arena::retire() {
+  bool destroy;
+  {
+    std::lock_guard<std::mutex> lock(remote_mutex);
+    for (void* ptr : remote_frees) {
+      BlockHeader* header = get_header(ptr);
+      if (header->live) {
+        header->live = false;
+        --live_blocks;
+      }
+    }
+    remote_frees.clear();
+    retired = true;
+    destroy = live_blocks == 0;
+  }
+  if (destroy) {
+    delete this;
+  }
+}
+
+inline index_t Arena::get_reserved_bytes() const {
+  index_t bytes = 0;
+  for (const Chunk& chunk : chunks) {
+    bytes += chunk.size;
+  }
+  return bytes;
+}
+
+inline Arena::ThreadArena& Arena::get_thread_holder() {
+  thread_local ThreadArena holder;
+  return holder;
+}
+
+inline Arena& Arena::get_thread_arena() {
+  ThreadArena& holder = get_thread_holder();
+  if (holder.arena == nullptr) {
+    holder.arena = new Arena();
+  }
+  return *holder.arena;
+}
+
+// Releases every arena block allocated by the current thread during the
+// lifetime of the scope. Scopes nest.
+class WorkspaceScope {
+ private:
+  Arena& arena;
+  Arena::Mark mark;
+  Arena::Mark enclosing_mark;
+
+ public:
+  WorkspaceScope()
+      : arena(Arena::get_thread_arena()),
+        mark(arena.mark()),
+        enclosing_mark(arena.scope_mark) {
+    arena.scope_mark = mark;
+  }
+  WorkspaceScope(const WorkspaceScope&) = delete;
+  WorkspaceScope& operator=(const WorkspaceScope&) = delete;
+  ~WorkspaceScope() {
+    arena.release(mark);
+    arena.scope_mark = enclosing_mark;
+  }
+};
+
+// IAllocator backed by the arena of the calling thread. Allocations count
+// elements of T, as with Allocator. Blocks may be freed or resized on any
+// thread.
+template <typename T>
+class ArenaAllocator : public IAllocator<T> {
+ public:
+  ArenaAllocator() = default;
+  ~ArenaAllocator() = default;
+  // disable copy constructor, copy assignment and move assigment
+  ArenaAllocator(const ArenaAllocator& a) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator& a) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator&& a) = delete;
+  void* allocate(size_t size);
+  // grows in place while the size class of the block suffices
+  void* resize(void* base_ptr, size_t size);
+  void free(void* addr);
+};
+
+// blocks are unscoped, the owner (e.g. a Buffer) frees them
+template <typename T>
+void* ArenaAllocator<T>::allocate(size_t size) {
+  return Arena::get_thread_arena().allocate(size * sizeof(T), false);
+}
+
+// a moved block is allocated from the arena of the calling thread and the old
+// block is returned to the arena it came from
+template <typename T>
+void* ArenaAllocator<T>::resize(void* base_ptr, size_t size) {
+  Arena& arena = Arena::get_thread_arena();
+  const index_t block_size = arena.get_block_size(base_ptr);
+  if (size * sizeof(T) <= block_size) {
+    return base_ptr;
+  }
+  void* ptr = arena.allocate(size * sizeof(T), false);
+  memcpy(ptr, base_ptr, block_size);
+  arena.free(base_ptr);
+  return ptr;
+}
+
+template <typename T>
+void ArenaAllocator<T>::free(void* addr) {
+  Arena::get_thread_arena().free(addr);
+}
+
+template <typename T>
+std::shared_ptr<IAllocator<T>> GetArenaAllocator() {
+  static std::shared_ptr<ArenaAllocator<T>> allocator =
+      std::make_shared<ArenaAllocator<T>>();
+  return allocator;
+}
+
+#endif
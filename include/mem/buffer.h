@@ -13,6 +13,10 @@
 
 #include <memory.h>
 
+#include <algorithm>
+#include <stdexcept>
+
+#include "../constants/constants.h"
 #include "buffer_interface.h"
 
 template <typename T>
@@ -24,6 +28,12 @@ class Buffer : public IBuffer<T> {
   void* mapped_base_ptr;
   std::shared_ptr<IAllocator<T>> allocator;
   bool is_data_owner;
+  // bytes available at base_ptr (size() <= capacity())
+  size_t _capacity;
+  // number of T elements the allocator provides for nbytes
+  static size_t elements(size_t nbytes) {
+    return (nbytes + sizeof(T) - 1) / sizeof(T);
+  }
 
  public:
   // initializes a Buffer and assigns the creator as
@@ -33,7 +43,8 @@ class Buffer : public IBuffer<T> {
         base_ptr(nullptr),
         mapped_base_ptr(nullptr),
         allocator(allocator),
-        is_data_owner(true) {}
+        is_data_owner(true),
+        _capacity(0) {}
   // encapsulates existing memory area as a Buffer managed
   // entity. Since memory was not allocated by the buffer,
   // ownership is not awarded.
@@ -42,7 +53,8 @@ class Buffer : public IBuffer<T> {
         base_ptr(data),
         mapped_base_ptr(nullptr),
         allocator(allocator),
-        is_data_owner(false) {}
+        is_data_owner(false),
+        _capacity(size) {}
   // disable copy and move assignment operators
   Buffer& operator=(const Buffer& a) = delete;
   Buffer& operator=(const Buffer&& a) = delete;
@@ -50,9 +62,14 @@ class Buffer : public IBuffer<T> {
   void* get_buffer_addr() noexcept;
   const void* raw_data() const noexcept;
   void* raw_mutable_data() noexcept;
-  bool allocate(index_t size);
+  // allocates nbytes for an empty buffer
+  bool allocate(index_t nbytes);
   bool allocate(std::vector<size_t>& shape);
-  bool resize(index_t size);
+  // sets the size to nbytes. Sizes within the capacity neither allocate nor
+  // move the data. Otherwise the capacity grows geometrically (at least by
+  // BUFFER_GROWTH_FACTOR) and the data is preserved.
+  bool resize(index_t nbytes);
+  size_t capacity() const { return _capacity; }
   void copy(void* src, index_t offset, index_t length);
   void clear();
   void clear(index_t size);
@@ -93,16 +110,16 @@ void* Buffer<T>::raw_mutable_data() noexcept {
 }
 
 template <typename T>
-bool Buffer<T>::allocate(index_t size) {
+bool Buffer<T>::allocate(index_t nbytes) {
   if (!is_data_owner) {
     throw std::runtime_error("non data owner cannot allocate memory");
-    if (this->base_ptr == nullptr) {
-      this->allocator->allocate(size);
-      this->_size = size;
-    } else {
-      throw std::runtime_error("buffer already allocated");
-    }
   }
+  if (this->base_ptr != nullptr) {
+    throw std::runtime_error("buffer already allocated");
+  }
+  this->base_ptr = this->allocator->allocate(elements(nbytes));
+  this->_size = nbytes;
+  this->_capacity = nbytes;
   return true;
 }
 
@@ -111,23 +128,27 @@ bool Buffer<T>::allocate(std::vector<size_t>& shape) {
   size_t num_bytes = std::accumulate(shape.begin(), shape.end(), 1,
                                      std::multiplies<size_t>()) *
                      sizeof(T);
-  this->base_ptr = this->allocator->allocate(num_bytes);
-  this->_size = num_bytes;
-  return true;
+  return this->allocate(num_bytes);
 }
 
 template <typename T>
-bool Buffer<T>::resize(index_t size) {
+bool Buffer<T>::resize(index_t nbytes) {
+  if (nbytes <= this->_capacity) {
+    this->_size = nbytes;
+    return true;
+  }
   if (!is_data_owner) {
     throw std::runtime_error("non data owner cannot allocate memory");
   }
+  const size_t capacity =
+      std::max<size_t>(nbytes, this->_capacity * BUFFER_GROWTH_FACTOR);
   if (this->base_ptr == nullptr) {
-    this->base_ptr = this->allocator->allocate(size);
-    this->_size = size;
+    this->base_ptr = this->allocator->allocate(elements(capacity));
   } else {
-    this->base_ptr = this->allocator->resize(base_ptr, size);
-    this->_size = size;
+    this->base_ptr = this->allocator->resize(base_ptr, elements(capacity));
   }
+  this->_size = nbytes;
+  this->_capacity = capacity;
   return true;
 }
 
@@ -8,6 +8,9 @@
  ******************************************************************************/
 /* Malith Jayaweera
 *******************************************************************************/
+#ifndef __BUFFER_INTERFACE_H__
+#define __BUFFER_INTERFACE_H__
+
 #include <numeric>
 #include <vector>
 
@@ -32,7 +35,11 @@ class IBuffer {
   virtual void clear() = 0;
   virtual void clear(index_t size) = 0;
   virtual index_t offset() const { return 0; }
+  // number of bytes the buffer holds without reallocating
+  virtual size_t capacity() const { return _size; }
   const T *data() const { return reinterpret_cast<const T *>(raw_data()); }
   T *mutable_data() { return reinterpret_cast<T *>(raw_mutable_data()); }
   size_t size() const { return _size; }
-};
\ No newline at end of file
+};
+
+#endif
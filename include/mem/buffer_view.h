@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __BUFFER_VIEW_H__
+#define __BUFFER_VIEW_H__
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "buffer_interface.h"
+
+// BufferView exposes the byte range [offset, offset + size) of a parent
+// buffer. The view shares ownership of the parent, hence the memory stays
+// valid for as long as any view (or Tensor bound to it) is alive. Views never
+// allocate; resizing is limited to the range they were created with.
+template <typename T>
+class BufferView : public IBuffer<T> {
+ private:
+  std::shared_ptr<IBuffer<T>> parent;
+  index_t _offset;
+  size_t _capacity;
+
+ public:
+  BufferView(std::shared_ptr<IBuffer<T>> parent, index_t offset, index_t size)
+      : IBuffer<T>(size), parent(parent), _offset(offset), _capacity(size) {
+    if (parent == nullptr) {
+      throw std::invalid_argument("buffer view requires a parent buffer");
+    }
+    if (offset + size > parent->size()) {
+      throw std::out_of_range(
+          "buffer view [" + std::to_string(offset) + ", " +
+          std::to_string(offset + size) + ") exceeds parent buffer size " +
+          std::to_string(parent->size()));
+    }
+  }
+  BufferView& operator=(const BufferView& a) = delete;
+  virtual ~BufferView() = default;
+  void* get_buffer_addr() noexcept { return raw_mutable_data(); }
+  const void* raw_data() const noexcept {
+    return static_cast<const unsigned char*>(parent->raw_data()) + _offset;
+  }
+  void* raw_mutable_data() noexcept {
+    return static_cast<unsigned char*>(parent->raw_mutable_data()) + _offset;
+  }
+  bool allocate(index_t nbytes) {
+    throw std::runtime_error("buffer view cannot allocate memory");
+  }
+  bool allocate(std::vector<size_t>& shape) {
+    throw std::runtime_error("buffer view cannot allocate memory");
+  }
+  bool resize(index_t nbytes) {
+    if (nbytes > _capacity) {
+      throw std::runtime_error("buffer view cannot grow beyond " +
+                               std::to_string(_capacity) + " bytes");
+    }
+    this->_size = nbytes;
+    return true;
+  }
+  void copy(void* src, index_t offset, index_t length) {
+    memcpy(static_cast<unsigned char*>(raw_mutable_data()) + offset, src,
+           length);
+  }
+  void clear() { clear(this->_size); }
+  void clear(index_t size) { memset(raw_mutable_data(), 0, size); }
+  index_t offset() const { return _offset; }
+  size_t capacity() const { return _capacity; }
+  std::shared_ptr<IBuffer<T>> get_parent() const { return parent; }
+};
+
+#endif
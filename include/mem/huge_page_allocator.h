@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __HUGE_PAGE_ALLOCATOR_H__
+#define __HUGE_PAGE_ALLOCATOR_H__
+
+#include <sys/mman.h>
+
+#include <memory>
+
+#include "page_allocator.h"
+
+// HugePageAllocator backs allocations with 2 MiB pages. With use_hugetlb the
+// pages are taken from the reserved hugetlbfs pool (MAP_HUGETLB), falling back
+// to transparent huge pages (MADV_HUGEPAGE on a 2 MiB aligned mapping) when
+// the pool is exhausted. populate pre-faults the pages at allocation time,
+// moving page faults off the hot path.
+template <typename T>
+class HugePageAllocator : public PageAllocator<T> {
+ private:
+  bool use_hugetlb;
+  bool populate;
+
+ protected:
+  void* map_pages(size_t bytes, size_t* length);
+
+ public:
+  explicit HugePageAllocator(bool use_hugetlb = false, bool populate = false)
+      : use_hugetlb(use_hugetlb), populate(populate) {}
+  ~HugePageAllocator() = default;
+};
+
+template <typename T>
+void* HugePageAllocator<T>::map_pages(size_t bytes, size_t* length) {
+  *length = (bytes + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+  if (use_hugetlb) {
+    void* base = mmap(nullptr, *length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                          (populate ? MAP_POPULATE : 0),
+                      -1, 0);
+    if (base != MAP_FAILED) {
+      return base;
+    }
+  }
+  void* base = map_aligned(*length, HUGE_PAGE_BYTES);
+  if (base == nullptr) {
+    return nullptr;
+  }
+  madvise(base, *length, MADV_HUGEPAGE);
+  if (populate) {
+    prefault_pages(base, *length);
+  }
+  return base;
+}
+
+template <typename T>
+std::shared_ptr<IAllocator<T>> GetHugePageAllocator() {
+  static std::shared_ptr<HugePageAllocator<T>> allocator =
+      std::make_shared<HugePageAllocator<T>>();
+  return allocator;
+}
+
+#endif
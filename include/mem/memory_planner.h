@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __MEMORY_PLANNER_H__
+#define __MEMORY_PLANNER_H__
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../constants/constants.h"
+#include "allocator.h"
+#include "buffer.h"
+#include "buffer_view.h"
+
+// MemoryPlanner assigns the intermediate tensors of a sequence of ops to
+// offsets within a single arena. Every tensor is registered with its size and
+// the (inclusive) range of op indices during which it must be alive. Tensors
+// whose lifetimes do not overlap may share memory.
+//
+// Offsets are assigned greedily by size: tensors are placed largest first at
+// the lowest ALIGN_BYTE_SIZE aligned offset that does not collide with an
+// already placed tensor of overlapping lifetime. The planned buffers are
+// non-owning views of the arena and can be bound to tensors through
+// Tensor(std::shared_ptr<IBuffer<T>>) followed by reshape().
+template <typename T>
+class MemoryPlanner {
+ private:
+  struct Record {
+    index_t nbytes;
+    index_t first_use;
+    index_t last_use;
+    index_t offset;
+  };
+  std::shared_ptr<IAllocator<T>> allocator;
+  std::vector<Record> records;
+  std::shared_ptr<Buffer<T>> arena;
+  index_t arena_size;
+  bool is_planned;
+
+  static index_t align(index_t nbytes) {
+    return (nbytes + ALIGN_BYTE_SIZE - 1) & ~(ALIGN_BYTE_SIZE - 1);
+  }
+  static bool overlaps(const Record& a, const Record& b) {
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+  }
+  void check_id(index_t id) const {
+    if (id >= records.size()) {
+      throw std::out_of_range("unknown planned tensor: " + std::to_string(id));
+    }
+  }
+
+ public:
+  explicit MemoryPlanner(
+      std::shared_ptr<IAllocator<T>> allocator = GetCPUAllocator<T>())
+      : allocator(allocator),
+        arena(nullptr),
+        arena_size(0),
+        is_planned(false) {}
+  // registers a tensor of nbytes alive from op first_use to op last_use and
+  // returns its id
+  index_t add(index_t nbytes, index_t first_use, index_t last_use);
+  // registers a tensor of the given dimensions
+  index_t add(const std::vector<index_t>& dims, index_t first_use,
+              index_t last_use);
+  // computes the offsets and allocates the arena
+  void plan();
+  index_t get_offset(index_t id) const;
+  index_t get_arena_size() const { return arena_size; }
+  // bytes required when every tensor owns its memory
+  index_t get_unplanned_size() const;
+  // non-owning view of the arena backing tensor id
+  std::shared_ptr<IBuffer<T>> get_buffer(index_t id);
+};
+
+template <typename T>
+index_t MemoryPlanner<T>::add(index_t nbytes, index_t first_use,
+                              index_t last_use) {
+  if (is_planned) {
+    throw std::runtime_error("cannot add tensors to an executed plan");
+  }
+  if (first_use > last_use) {
+    throw std::invalid_argument(
+        "tensor lifetime must satisfy: " + std::to_string(first_use) +
+        " <= " + std::to_string(last_use));
+  }
+  records.push_back({nbytes, first_use, last_use, 0});
+  return records.size() - 1;
+}
+
+template <typename T>
+index_t MemoryPlanner<T>::add(const std::vector<index_t>& dims,
+                              index_t first_use, index_t last_use) {
+  const index_t size = std::accumulate(dims.begin(), dims.end(), 1,
+                                       std::multiplies<index_t>());
+  return add(size * sizeof(T), first_use, last_use);
+}
+
+template <typename T>
+void MemoryPlanner<T>::plan() {
+  if (is_planned) {
+    throw std::runtime_error("memory plan has already been executed");
+  }
+  std::vector<index_t> order(records.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](index_t a, index_t b) {
+    return records[a].nbytes > records[b].nbytes;
+  });
+  std::vector<index_t> placed;
+  std::vector<index_t> conflicts;
+  for (index_t id : order) {
+    Record& record = records[id];
+    conflicts.clear();
+    for (index_t other : placed) {
+      if (overlaps(record, records[other])) conflicts.push_back(other);
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [&](index_t a, index_t b) {
+      return records[a].offset < records[b].offset;
+    });
+    // first gap between live tensors that fits the record
+    index_t offset = 0;
+    for (index_t other : conflicts) {
+      const Record& live = records[other];
+      if (offset + record.nbytes <= live.offset) break;
+      offset = std::max(offset, align(live.offset + live.nbytes));
+    }
+    record.offset = offset;
+    arena_size = std::max(arena_size, align(offset + record.nbytes));
+    placed.push_back(id);
+  }
+  arena = std::make_shared<Buffer<T>>(allocator);
+  arena->resize(arena_size);
+  is_planned = true;
+}
+
+template <typename T>
+index_t MemoryPlanner<T>::get_offset(index_t id) const {
+  check_id(id);
+  if (!is_planned) {
+    throw std::runtime_error("memory plan has not been executed");
+  }
+  return records[id].offset;
+}
+
+template <typename T>
+index_t MemoryPlanner<T>::get_unplanned_size() const {
+  index_t size = 0;
+  for (const Record& record : records) {
+    size += align(record.nbytes);
+  }
+  return size;
+}
+
+template <typename T>
+std::shared_ptr<IBuffer<T>> MemoryPlanner<T>::get_buffer(index_t id) {
+  const index_t offset = get_offset(id);
+  return std::make_shared<BufferView<T>>(arena, offset, records[id].nbytes);
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __NUMA_ALLOCATOR_H__
+#define __NUMA_ALLOCATOR_H__
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "page_allocator.h"
+
+// node of the CPU executing the calling thread
+inline int get_current_numa_node() {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return static_cast<int>(node);
+}
+
+// NumaAllocator places allocations on a single NUMA node. node selects the
+// node explicitly, while the default (-1) picks the node of the allocating
+// thread. The pages are bound with mbind. Where binding is not permitted the
+// allocator relies on the first touch policy instead, hence populate (on by
+// default) faults the pages in from the allocating thread.
+template <typename T>
+class NumaAllocator : public PageAllocator<T> {
+ private:
+  int node;
+  bool populate;
+
+ protected:
+  void* map_pages(size_t bytes, size_t* length);
+
+ public:
+  explicit NumaAllocator(int node = -1, bool populate = true)
+      : node(node), populate(populate) {}
+  ~NumaAllocator() = default;
+  int get_node() const { return node; }
+};
+
+template <typename T>
+void* NumaAllocator<T>::map_pages(size_t bytes, size_t* length) {
+  const size_t page_size = sysconf(_SC_PAGE_SIZE);
+  *length = (bytes + page_size - 1) & ~(page_size - 1);
+  void* base = map_aligned(*length, page_size);
+  if (base == nullptr) {
+    return nullptr;
+  }
+  const int target = node >= 0 ? node : get_current_numa_node();
+  const unsigned long max_node = sizeof(unsigned long) * 8;
+  if (target < static_cast<int>(max_node)) {
+    const unsigned long node_mask = 1UL << target;
+    syscall(SYS_mbind, base, *length, MPOL_BIND, &node_mask, max_node, 0);
+  }
+  if (populate) {
+    prefault_pages(base, *length);
+  }
+  return base;
+}
+
+template <typename T>
+std::shared_ptr<IAllocator<T>> GetNumaAllocator() {
+  static std::shared_ptr<NumaAllocator<T>> allocator =
+      std::make_shared<NumaAllocator<T>>();
+  return allocator;
+}
+
+#endif
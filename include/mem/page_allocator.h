@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __PAGE_ALLOCATOR_H__
+#define __PAGE_ALLOCATOR_H__
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include "../constants/constants.h"
+#include "allocator_interface.h"
+
+// Maps bytes (a multiple of the page size) of anonymous memory starting at an
+// address aligned to alignment (a power of two multiple of the page size).
+// Returns nullptr on failure.
+inline void* map_aligned(size_t bytes, size_t alignment, int flags = 0) {
+  const size_t length = bytes + alignment;
+  void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+  const uintptr_t addr = reinterpret_cast<uintptr_t>(base);
+  const uintptr_t start = (addr + alignment - 1) & ~(alignment - 1);
+  const size_t head = start - addr;
+  const size_t tail = length - head - bytes;
+  if (head) {
+    munmap(base, head);
+  }
+  if (tail) {
+    munmap(reinterpret_cast<void*>(start + bytes), tail);
+  }
+  return reinterpret_cast<void*>(start);
+}
+
+// Writes one byte per page such that the pages are faulted in by the calling
+// thread.
+inline void prefault_pages(void* base, size_t bytes) {
+  const size_t page_size = sysconf(_SC_PAGE_SIZE);
+  volatile unsigned char* ptr = static_cast<unsigned char*>(base);
+  for (size_t i = 0; i < bytes; i += page_size) {
+    ptr[i] = 0;
+  }
+}
+
+// PageAllocator is the base of the allocators that map memory directly from
+// the kernel. The length of each mapping is stored in the ALIGN_BYTE_SIZE
+// bytes preceding the returned address. Derived allocators decide how the
+// pages are mapped and placed. Allocations count elements of T, as with
+// Allocator.
+template <typename T>
+class PageAllocator : public IAllocator<T> {
+ protected:
+  // maps at least bytes bytes. returns the base of the mapping and its length
+  // or nullptr on failure.
+  virtual void* map_pages(size_t bytes, size_t* length) = 0;
+
+ public:
+  PageAllocator() = default;
+  virtual ~PageAllocator() = default;
+  // disable copy constructor, copy assignment and move assigment
+  PageAllocator(const PageAllocator& a) = delete;
+  PageAllocator& operator=(const PageAllocator& a) = delete;
+  PageAllocator& operator=(const PageAllocator&& a) = delete;
+  void* allocate(size_t size);
+  // grows in place while the mapping is large enough
+  void* resize(void* base_ptr, size_t size);
+  void free(void* addr);
+  // number of bytes usable at addr
+  size_t get_capacity(void* addr) const;
+};
+
+template <typename T>
+void* PageAllocator<T>::allocate(size_t size) {
+  size_t length = 0;
+  void* base = this->map_pages(ALIGN_BYTE_SIZE + size * sizeof(T), &length);
+  if (base == nullptr) {
+    throw std::bad_alloc();
+  }
+  *static_cast<size_t*>(base) = length;
+  return static_cast<unsigned char*>(base) + ALIGN_BYTE_SIZE;
+}
+
+template <typename T>
+size_t PageAllocator<T>::get_capacity(void* addr) const {
+  const unsigned char* base =
+      static_cast<unsigned char*>(addr) - ALIGN_BYTE_SIZE;
+  return *reinterpret_cast<const size_t*>(base) - ALIGN_BYTE_SIZE;
+}
+
+template <typename T>
+void* PageAllocator<T>::resize(void* base_ptr, size_t size) {
+  const size_t capacity = this->get_capacity(base_ptr);
+  if (size * sizeof(T) <= capacity) {
+    return base_ptr;
+  }
+  void* ptr = this->allocate(size);
+  memcpy(ptr, base_ptr, capacity);
+  this->free(base_ptr);
+  return ptr;
+}
+
+template <typename T>
+void PageAllocator<T>::free(void* addr) {
+  if (addr == nullptr) {
+    return;
+  }
+  unsigned char* base = static_cast<unsigned char*>(addr) - ALIGN_BYTE_SIZE;
+  munmap(base, *reinterpret_cast<size_t*>(base));
+}
+
+#endif
@@ -0,0 +1,252 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#ifndef __REORDER_H__
+#define __REORDER_H__
+
+#include <immintrin.h>
+#include <string.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../constants/constants.h"
+#include "../mat/transpose.h"
+#include "tensor.h"
+
+// Conversions between the activation layouts of layout_t. Every reorder is
+// parallelized over (batch, channel block, spatial tile) with OpenMP and
+// visits the image in TRANSPOSE_BLOCK_SIZE pixel tiles so that the source and
+// destination tiles of a thread stay in cache. hw is the number of pixels
+// (height * width) of one image.
+
+// [N][C][HW] -> [N][HW][C]
+inline void reorder_nchw_to_nhwc(const float* src, index_t batch,
+                                 index_t channels, index_t hw, float* dst) {
+  const index_t tiles = (hw + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel for collapse(2) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t t = 0; t < tiles; ++t) {
+      const index_t p = t * TRANSPOSE_BLOCK_SIZE;
+      const index_t pixels = std::min(TRANSPOSE_BLOCK_SIZE, hw - p);
+      transpose_blocked(src + b * channels * hw + p, channels, pixels, hw,
+                        dst + (b * hw + p) * channels, channels);
+    }
+  }
+}
+
+// [N][HW][C] -> [N][C][HW]
+inline void reorder_nhwc_to_nchw(const float* src, index_t batch,
+                                 index_t channels, index_t hw, float* dst) {
+  const index_t tiles = (hw + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel for collapse(2) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t t = 0; t < tiles; ++t) {
+      const index_t p = t * TRANSPOSE_BLOCK_SIZE;
+      const index_t pixels = std::min(TRANSPOSE_BLOCK_SIZE, hw - p);
+      transpose_blocked(src + (b * hw + p) * channels, pixels, channels,
+                        channels, dst + b * channels * hw + p, hw);
+    }
+  }
+}
+
+// [N][C][HW] -> [N][C / 16][HW][16]. Each channel block is a 16 x HW slice of
+// the image transposed 16x16 registers at a time. The padding channels of the
+// last block are zero filled by the masked loads.
+inline void reorder_nchw_to_nchw16c(const float* src, index_t batch,
+                                    index_t channels, index_t hw, float* dst) {
+  const index_t blocks = RoundUp(channels, CHANNEL_BLOCK_SIZE) /
+                         CHANNEL_BLOCK_SIZE;
+  const index_t tiles = (hw + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel for collapse(3) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t cb = 0; cb < blocks; ++cb) {
+      for (index_t t = 0; t < tiles; ++t) {
+        const index_t c = cb * CHANNEL_BLOCK_SIZE;
+        const index_t celem = std::min(CHANNEL_BLOCK_SIZE, channels - c);
+        const index_t p = t * TRANSPOSE_BLOCK_SIZE;
+        const index_t pixels = std::min(TRANSPOSE_BLOCK_SIZE, hw - p);
+        const float* in = src + (b * channels + c) * hw + p;
+        float* out = dst + ((b * blocks + cb) * hw + p) * CHANNEL_BLOCK_SIZE;
+        __m512 r[16];
+        for (index_t j = 0; j < pixels; j += 16) {
+          const index_t jelem = std::min<index_t>(16, pixels - j);
+          load_block16(in + j, celem, jelem, hw, r);
+          transpose16x16(r);
+          store_block16(out + j * CHANNEL_BLOCK_SIZE, jelem, 16,
+                        CHANNEL_BLOCK_SIZE, r);
+        }
+      }
+    }
+  }
+}
+
+// [N][C / 16][HW][16] -> [N][C][HW]
+inline void reorder_nchw16c_to_nchw(const float* src, index_t batch,
+                                    index_t channels, index_t hw, float* dst) {
+  const index_t blocks = RoundUp(channels, CHANNEL_BLOCK_SIZE) /
+                         CHANNEL_BLOCK_SIZE;
+  const index_t tiles = (hw + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel for collapse(3) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t cb = 0; cb < blocks; ++cb) {
+      for (index_t t = 0; t < tiles; ++t) {
+        const index_t c = cb * CHANNEL_BLOCK_SIZE;
+        const index_t celem = std::min(CHANNEL_BLOCK_SIZE, channels - c);
+        const index_t p = t * TRANSPOSE_BLOCK_SIZE;
+        const index_t pixels = std::min(TRANSPOSE_BLOCK_SIZE, hw - p);
+        const float* in =
+            src + ((b * blocks + cb) * hw + p) * CHANNEL_BLOCK_SIZE;
+        float* out = dst + (b * channels + c) * hw + p;
+        __m512 r[16];
+        for (index_t j = 0; j < pixels; j += 16) {
+          const index_t jelem = std::min<index_t>(16, pixels - j);
+          load_block16(in + j * CHANNEL_BLOCK_SIZE, jelem, 16,
+                       CHANNEL_BLOCK_SIZE, r);
+          transpose16x16(r);
+          store_block16(out + j, celem, jelem, hw, r);
+        }
+      }
+    }
+  }
+}
+
+// [N][HW][C] -> [N][C / 16][HW][16]. A pixel's channel block is one (masked)
+// vector, hence no transposition is required.
+inline void reorder_nhwc_to_nchw16c(const float* src, index_t batch,
+                                    index_t channels, index_t hw, float* dst) {
+  const index_t blocks = RoundUp(channels, CHANNEL_BLOCK_SIZE) /
+                         CHANNEL_BLOCK_SIZE;
+  const index_t tiles = (hw + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel for collapse(3) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t cb = 0; cb < blocks; ++cb) {
+      for (index_t t = 0; t < tiles; ++t) {
+        const index_t c = cb * CHANNEL_BLOCK_SIZE;
+        const index_t celem = std::min(CHANNEL_BLOCK_SIZE, channels - c);
+        const __mmask16 cmask = static_cast<__mmask16>(~(0xffffffff << celem));
+        const index_t p = t * TRANSPOSE_BLOCK_SIZE;
+        const index_t pixels = std::min(TRANSPOSE_BLOCK_SIZE, hw - p);
+        const float* in = src + (b * hw + p) * channels + c;
+        float* out = dst + ((b * blocks + cb) * hw + p) * CHANNEL_BLOCK_SIZE;
+        for (index_t j = 0; j < pixels; ++j) {
+          _mm512_storeu_ps(out + j * CHANNEL_BLOCK_SIZE,
+                           _mm512_maskz_loadu_ps(cmask, in + j * channels));
+        }
+      }
+    }
+  }
+}
+
+// [N][C / 16][HW][16] -> [N][HW][C]
+inline void reorder_nchw16c_to_nhwc(const float* src, index_t batch,
+                                    index_t channels, index_t hw, float* dst) {
+  const index_t blocks = RoundUp(channels, CHANNEL_BLOCK_SIZE) /
+                         CHANNEL_BLOCK_SIZE;
+  const index_t tiles = (hw + TRANSPOSE_BLOCK_SIZE - 1) / TRANSPOSE_BLOCK_SIZE;
+#pragma omp parallel for collapse(3) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t cb = 0; cb < blocks; ++cb) {
+      for (index_t t = 0; t < tiles; ++t) {
+        const index_t c = cb * CHANNEL_BLOCK_SIZE;
+        const index_t celem = std::min(CHANNEL_BLOCK_SIZE, channels - c);
+        const __mmask16 cmask = static_cast<__mmask16>(~(0xffffffff << celem));
+        const index_t p = t * TRANSPOSE_BLOCK_SIZE;
+        const index_t pixels = std::min(TRANSPOSE_BLOCK_SIZE, hw - p);
+        const float* in =
+            src + ((b * blocks + cb) * hw + p) * CHANNEL_BLOCK_SIZE;
+        float* out = dst + (b * hw + p) * channels + c;
+        for (index_t j = 0; j < pixels; ++j) {
+          _mm512_mask_storeu_ps(out + j * channels, cmask,
+                                _mm512_loadu_ps(in + j * CHANNEL_BLOCK_SIZE));
+        }
+      }
+    }
+  }
+}
+
+// Copies the strided view src (dimensions N, C, H, W) densely in to dst in
+// the element order of its layout.
+inline void reorder_gather(const Tensor<float>& src, float* dst) {
+  const index_t batch = src.dim(0);
+  const index_t channels = src.dim(1);
+  const index_t height = src.dim(2);
+  const index_t width = src.dim(3);
+  const bool nhwc = src.get_layout() == LAYOUT_NHWC;
+  const float* in = src.data();
+#pragma omp parallel for collapse(2) schedule(static)
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t c = 0; c < channels; ++c) {
+      for (index_t h = 0; h < height; ++h) {
+        for (index_t w = 0; w < width; ++w) {
+          const index_t p = h * width + w;
+          const index_t index = nhwc
+                                    ? (b * height * width + p) * channels + c
+                                    : (b * channels + c) * height * width + p;
+          dst[index] = in[b * src.stride(0) + c * src.stride(1) +
+                          h * src.stride(2) + w * src.stride(3)];
+        }
+      }
+    }
+  }
+}
+
+// Converts the 4D tensor src (dimensions N, C, H, W) in to the given layout.
+// dst is tagged and resized accordingly. Strided views (see Tensor::view) are
+// gathered in to a dense copy of their layout first.
+inline void reorder(const Tensor<float>& src, Tensor<float>* dst,
+                    layout_t layout) {
+  const std::vector<index_t> dims = src.get_dims();
+  if (dims.size() != 4) {
+    throw std::invalid_argument("reorder requires a 4D tensor, found " +
+                                std::to_string(dims.size()) + " dimensions");
+  }
+  if (!src.is_contiguous()) {
+    if (src.get_layout() == layout) {
+      dst->set_layout(layout);
+      dst->resize(dims);
+      reorder_gather(src, dst->mutable_data());
+    } else {
+      Tensor<float> dense;
+      dense.set_layout(src.get_layout());
+      dense.resize(dims);
+      reorder_gather(src, dense.mutable_data());
+      reorder(dense, dst, layout);
+    }
+    return;
+  }
+  const index_t batch = dims[0];
+  const index_t channels = dims[1];
+  const index_t hw = dims[2] * dims[3];
+  dst->set_layout(layout);
+  dst->resize(dims);
+  const float* in = src.data();
+  float* out = dst->mutable_data();
+  const layout_t from = src.get_layout();
+  if (from == layout) {
+    memcpy(out, in, src.raw_size());
+  } else if (from == LAYOUT_NCHW && layout == LAYOUT_NHWC) {
+    reorder_nchw_to_nhwc(in, batch, channels, hw, out);
+  } else if (from == LAYOUT_NHWC && layout == LAYOUT_NCHW) {
+    reorder_nhwc_to_nchw(in, batch, channels, hw, out);
+  } else if (from == LAYOUT_NCHW && layout == LAYOUT_NCHW16C) {
+    reorder_nchw_to_nchw16c(in, batch, channels, hw, out);
+  } else if (from == LAYOUT_NCHW16C && layout == LAYOUT_NCHW) {
+    reorder_nchw16c_to_nchw(in, batch, channels, hw, out);
+  } else if (from == LAYOUT_NHWC && layout == LAYOUT_NCHW16C) {
+    reorder_nhwc_to_nchw16c(in, batch, channels, hw, out);
+  } else if (from == LAYOUT_NCHW16C && layout == LAYOUT_NHWC) {
+    reorder_nchw16c_to_nhwc(in, batch, channels, hw, out);
+  } else {
+    throw std::invalid_argument("unsupported layout conversion");
+  }
+}
+
+#endif
@@ -15,6 +15,8 @@
 
 #include "mem/allocator.h"
 #include "mem/buffer.h"
+#include "mem/buffer_view.h"
+#include "utils/utils.h"
 
 template <typename T>
 class Tensor {
@@ -22,7 +24,12 @@ class Tensor {
   // memory managers
   std::shared_ptr<IAllocator<T>> allocator;
   std::shared_ptr<IBuffer<T>> buffer;
+  // logical dimensions (N, C, H, W for activations) regardless of layout
   std::vector<index_t> dims;
+  // element distance between neighbours along each logical dimension. Views
+  // may use arbitrary strides, blocked layouts have none.
+  std::vector<index_t> strides;
+  layout_t layout;
   bool is_buffer_owner;
   std::string name;
   bool is_weight;
@@ -30,12 +37,16 @@ class Tensor {
   float scale;
   float min_value;
   float max_value;
+  void check_layout() const;
+  std::vector<index_t> contiguous_strides() const;
+  void check_contiguous(const std::string& operation) const;
 
  public:
   Tensor(std::shared_ptr<IAllocator<T>> alloc, bool is_weight = false,
          const std::string name = "")
       : allocator(alloc),
         buffer(nullptr),
+        layout(LAYOUT_NCHW),
         is_buffer_owner(true),
         name(name),
         is_weight(is_weight),
@@ -45,6 +56,7 @@ class Tensor {
   Tensor(std::shared_ptr<IBuffer<T>> buffer, bool is_weight = false,
          const std::string name = "")
       : buffer(buffer),
+        layout(LAYOUT_NCHW),
         is_buffer_owner(false),
         name(name),
         is_weight(is_weight),
@@ -53,16 +65,34 @@ class Tensor {
         max_value(0.f) {}
   explicit Tensor(bool is_weight = false)
       : Tensor(GetCPUAllocator<T>(), is_weight) {}
+  // number of stored elements. Includes the channel padding of blocked
+  // layouts.
   index_t size() const;
   index_t raw_size() const;
   index_t dim(index_t axis) const;
   std::vector<index_t> get_dims() const;
+  index_t stride(index_t axis) const { return strides[axis]; }
+  std::vector<index_t> get_strides() const { return strides; }
+  // whether the elements are densely packed in the order of the layout
+  bool is_contiguous() const { return strides == contiguous_strides(); }
+  // returns a tensor sharing the memory of this tensor, covering sizes[i]
+  // elements along dimension i starting at offsets[i]. Non-zero steps select
+  // every steps[i]-th element (default 1). No data is copied; the view keeps
+  // the memory alive and its dimensions cannot be changed.
+  std::shared_ptr<Tensor<T>> view(const std::vector<index_t>& offsets,
+                                  const std::vector<index_t>& sizes,
+                                  const std::vector<index_t>& steps = {});
+  layout_t get_layout() const { return layout; }
+  // tags the memory layout of a 4D tensor. The storage is accounted for by
+  // the next resize or reshape, hence the tag is usually set beforehand.
+  void set_layout(layout_t layout);
   const T* data() const;
   T* mutable_data();
   // reshape an already initialized tensor to
   // different dimensions.
   void reshape(const std::vector<index_t>& dims);
-  // resize a new tensor to different dimensions.
+  // resize a tensor to different dimensions. memory is reallocated only
+  // when the buffer capacity is exceeded.
   void resize(const std::vector<index_t>& dims);
   void clear();
   // friend access to private variables
@@ -74,8 +104,12 @@ class Tensor {
 
 template <typename T>
 index_t Tensor<T>::size() const {
-  return std::accumulate(dims.begin(), dims.end(), 1,
-                         std::multiplies<int64_t>());
+  const index_t size = std::accumulate(dims.begin(), dims.end(), 1,
+                                       std::multiplies<int64_t>());
+  if (layout != LAYOUT_NCHW16C || size == 0) {
+    return size;
+  }
+  return size / dims[1] * RoundUp(dims[1], CHANNEL_BLOCK_SIZE);
 }
 template <typename T>
 index_t Tensor<T>::raw_size() const {
@@ -92,6 +126,91 @@ std::vector<index_t> Tensor<T>::get_dims() const {
   return this->dims;
 }
 
+template <typename T>
+std::vector<index_t> Tensor<T>::contiguous_strides() const {
+  std::vector<index_t> contiguous(dims.size());
+  if (layout == LAYOUT_NCHW16C) {
+    return {};
+  }
+  if (layout == LAYOUT_NHWC && dims.size() == 4) {
+    // logical N, C, H, W stored as [N][H][W][C]
+    contiguous[1] = 1;
+    contiguous[3] = dims[1];
+    contiguous[2] = dims[3] * dims[1];
+    contiguous[0] = dims[2] * dims[3] * dims[1];
+    return contiguous;
+  }
+  index_t stride = 1;
+  for (index_t i = dims.size(); i-- > 0;) {
+    contiguous[i] = stride;
+    stride *= dims[i];
+  }
+  return contiguous;
+}
+
+template <typename T>
+void Tensor<T>::check_contiguous(const std::string& operation) const {
+  if (!is_contiguous()) {
+    throw std::runtime_error("cannot " + operation + " a strided view");
+  }
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> Tensor<T>::view(const std::vector<index_t>& offsets,
+                                           const std::vector<index_t>& sizes,
+                                           const std::vector<index_t>& steps) {
+  if (buffer == nullptr) {
+    throw std::runtime_error("buffer has not been initialized");
+  }
+  if (layout == LAYOUT_NCHW16C) {
+    throw std::invalid_argument("blocked layouts do not support views");
+  }
+  if (offsets.size() != dims.size() || sizes.size() != dims.size() ||
+      (!steps.empty() && steps.size() != dims.size())) {
+    throw std::invalid_argument("view requires " +
+                                std::to_string(dims.size()) + " dimensions");
+  }
+  std::vector<index_t> view_strides(dims.size());
+  index_t first = 0;
+  index_t last = 0;
+  for (index_t i = 0; i < dims.size(); ++i) {
+    const index_t step = steps.empty() ? 1 : steps[i];
+    if (sizes[i] == 0 || step == 0 ||
+        offsets[i] + (sizes[i] - 1) * step >= dims[i]) {
+      throw std::out_of_range(
+          "view along dimension " + std::to_string(i) + " exceeds size " +
+          std::to_string(dims[i]));
+    }
+    view_strides[i] = strides[i] * step;
+    first += offsets[i] * strides[i];
+    last += (sizes[i] - 1) * view_strides[i];
+  }
+  std::shared_ptr<IBuffer<T>> range = std::make_shared<BufferView<T>>(
+      buffer, first * sizeof(T), (last + 1) * sizeof(T));
+  std::shared_ptr<Tensor<T>> view =
+      std::make_shared<Tensor<T>>(range, is_weight, name);
+  view->dims = sizes;
+  view->strides = view_strides;
+  view->layout = layout;
+  return view;
+}
+
+template <typename T>
+void Tensor<T>::check_layout() const {
+  if (layout != LAYOUT_NCHW && dims.size() != 4) {
+    throw std::invalid_argument("layout requires a 4D tensor, found " +
+                                std::to_string(dims.size()) + " dimensions");
+  }
+}
+
+template <typename T>
+void Tensor<T>::set_layout(layout_t layout) {
+  check_contiguous("change the layout of");
+  this->layout = layout;
+  if (!dims.empty()) check_layout();
+  this->strides = contiguous_strides();
+}
+
 template <typename T>
 const T* Tensor<T>::data() const {
   return buffer->data();
@@ -128,7 +247,10 @@ constexpr T* Tensor<T>::operator()(index_t idx) {
 
 template <typename T>
 void Tensor<T>::reshape(const std::vector<index_t>& dims) {
+  check_contiguous("reshape");
   this->dims = dims;
+  check_layout();
+  this->strides = contiguous_strides();
   if (buffer == nullptr) {
     throw std::runtime_error("buffer has not been initialized");
   }
@@ -140,13 +262,17 @@ void Tensor<T>::reshape(const std::vector<index_t>& dims) {
 
 template <typename T>
 void Tensor<T>::resize(const std::vector<index_t>& dims) {
+  check_contiguous("resize");
   this->dims = dims;
+  check_layout();
+  this->strides = contiguous_strides();
   if (this->buffer == nullptr) {
     buffer = std::make_shared<Buffer<T>>(this->allocator);
-    const index_t modified_size = this->raw_size();
-    if (modified_size > this->buffer->size()) {
-      this->buffer->resize(modified_size);
-    }
+  }
+  // owned buffers keep their capacity, hence shapes that shrink or grow back
+  // within it do not reallocate
+  if (this->is_buffer_owner) {
+    this->buffer->resize(this->raw_size());
   }
   if (raw_size() > this->buffer->size())
     throw std::invalid_argument(
@@ -156,6 +282,7 @@ void Tensor<T>::resize(const std::vector<index_t>& dims) {
 
 template <typename T>
 void Tensor<T>::clear() {
+  check_contiguous("clear");
   if (this->buffer != nullptr) {
     this->buffer->clear();
   }
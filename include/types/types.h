@@ -23,5 +23,14 @@ typedef enum {
   JITMKL,
   JITLIBXSMM
 } gemm_library;
+typedef enum {
+  CPU_ALLOCATOR,
+  ARENA_ALLOCATOR,
+  HUGE_PAGE_ALLOCATOR,
+  NUMA_ALLOCATOR
+} allocator_t;
+// memory layout of 4D activation tensors. NCHW16C splits the channels in to
+// blocks of 16 (zero padded) stored innermost: [N][C / 16][H][W][16].
+typedef enum { LAYOUT_NCHW, LAYOUT_NHWC, LAYOUT_NCHW16C } layout_t;
 
 #endif
\ No newline at end of file
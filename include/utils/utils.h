@@ -11,9 +11,32 @@
 #ifndef __UTILS_H_
 #define __UTILS_H_
 
+#include <type_traits>
+#include <utility>
+
+#include "../types/types.h"
+
 template <typename Integer>
-Integer RoundUp(Integer i, Integer factor) {
+constexpr Integer RoundUp(Integer i, Integer factor) {
   return (i + factor - 1) / factor * factor;
 }
 
+// register arrays indexed in unrolled loops only live in registers once every
+// lambda of the loop is inlined, which GCC does not guarantee for large bodies
+#define FORCE_INLINE __attribute__((always_inline))
+
+// Calls f(std::integral_constant<index_t, I>{}) for I = 0, ..., N - 1. The
+// fold expression unrolls the loop at compile time so that register arrays
+// indexed by I are scalarized in to ZMM registers.
+template <typename F, index_t... I>
+FORCE_INLINE inline void static_for(F&& f,
+                                    std::integer_sequence<index_t, I...>) {
+  (f(std::integral_constant<index_t, I>{}), ...);
+}
+
+template <index_t N, typename F>
+FORCE_INLINE inline void static_for(F&& f) {
+  static_for(std::forward<F>(f), std::make_integer_sequence<index_t, N>{});
+}
+
 #endif
\ No newline at end of file
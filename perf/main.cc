@@ -135,8 +135,8 @@ int main(int argc, char *argv[]) {
 #endif
     for (index_t i = 0; i < iterations; ++i) {
 #ifdef ENABLE_JIT
-      MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, k, B_ROW_MAJOR, n, 0,
-                    C, n, jit_);
+      MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, m, B_ROW_MAJOR, n, 0,
+                    C, m, jit_);
 #else
       MARLIN::sgemm('N', 'N', m, n, k, 1.0, A_COL_MAJOR, k, B_ROW_MAJOR, n, 0,
                     C, n);
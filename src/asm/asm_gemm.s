@@ -16,24 +16,61 @@
 # 15 B COLS AND 1 A COLS.
 #
 # CALLING SEQUENCE IS AS FOLLOWS:
-#       RDI : M
+#       RDI : LDA (A COLUMN STRIDE IN ELEMENTS)
 #       RSI : K
-#       RDX : N
+#       RDX : LDC (C COLUMN STRIDE IN ELEMENTS)
 #       RCX : MATRIX A PTR
 #       R8  : MATRIX C PTR
 #       R9  : BASE PAGE ADDRESS
 # 0x10(EBP) : PAGE OFFSET DATA
 # 0x18(EBP) : MASK
 # 0x20(EBP) : B MATRIX IDX (CODE GEN INVOKER IDX)
+# 0x28(EBP) : ACCUMULATE (LOAD C INSTEAD OF ZEROING, K-SEGMENTED CODE)
+# 0x30(EBP) : A PREFETCH DISTANCE (NUMBER OF A COLS AHEAD)
 #
 # FUNCTION DEFINITION TO BE DECLARED IS AS FOLLOWS:
-#       extern "C" index_t asm_gemm(index_t m, index_t k, index_t n,
+#       extern "C" index_t asm_gemm(index_t lda, index_t k, index_t ldc,
 #                                   float *a, float *c, void *p_addr,
 #                                   index_t *offset_data, 
-#                                   uint16_t mask, index_t idx)
+#                                   uint16_t mask, index_t idx,
+#                                   index_t accumulate,
+#                                   index_t prefetch_distance)
 #                        
 #
 
+# ONE K ITERATION: LOAD THE A COL, SET THE B VALUES AND ACCUMULATE INTO C
+.macro GEMM_K_STEP
+    vmovups (%rcx), %zmm0{%k1}               # LOAD A COL TO REGISTER
+    # SET MATRIX B
+    movl %eax, %r14d                         # CALLER SAVE
+    movq %r9, %r13                           # MOV BASE PAGE ADDRESS
+    lea (%r8, %r10, 0x8), %r12               # OFFSET
+    movq (%r12), %r12
+    addq %r12, %r13                          # CALLABLE ADDRESS
+    callq *%r13                              # CALL FUNCTION TO SET MAT B
+    movl %r14d, %eax                         # CALLER RESTORE
+    # MATMUL
+    vfmadd231ps %zmm0, %zmm31, %zmm2         # z2 += z0 * z31
+    vfmadd231ps %zmm0, %zmm30, %zmm3         # z3 += z0 * z30
+    vfmadd231ps %zmm0, %zmm29, %zmm4         # z4 += z0 * z29
+    vfmadd231ps %zmm0, %zmm28, %zmm5         # z5 += z0 * z28
+    vfmadd231ps %zmm0, %zmm27, %zmm6         # z6 += z0 * z27
+    vfmadd231ps %zmm0, %zmm26, %zmm7         # z7 += z0 * z26
+    vfmadd231ps %zmm0, %zmm25, %zmm8         # z8 += z0 * z25
+    vfmadd231ps %zmm0, %zmm24, %zmm9         # z9 += z0 * z24
+    vfmadd231ps %zmm0, %zmm23, %zmm10        # z10 += z0 * z23
+    vfmadd231ps %zmm0, %zmm22, %zmm11        # z11 += z0 * z22
+    vfmadd231ps %zmm0, %zmm21, %zmm12        # z12 += z0 * z21
+    vfmadd231ps %zmm0, %zmm20, %zmm13        # z13 += z0 * z20
+    vfmadd231ps %zmm0, %zmm19, %zmm14        # z14 += z0 * z19
+    vfmadd231ps %zmm0, %zmm18, %zmm15        # z15 += z0 * z18
+    vfmadd231ps %zmm0, %zmm17, %zmm16        # z16 += z0 * z17
+    # LOOP CLEANUP                   
+    lea (%rcx, %rdi, 0x4), %rcx              # INCREMENT A MATRIX PTR
+    addl $1, %eax                            # i = i + 1
+    addl $1, %r10d                           # ID = ID + 1
+.endm
+
 .global asm_gemm
     .text
 asm_gemm:
@@ -47,9 +84,12 @@ asm_gemm:
     movq %r12, -0x10(%rbp)                   # [SAVE R12 REG TO STACK]
     movq %r13, -0x18(%rbp)                   # [SAVE R13 REG TO STACK]
     movq %r14, -0x20(%rbp)                   # [SAVE R14 REG TO STACK]
+    movq %rdx, -0x28(%rbp)                   # [SAVE LDC TO STACK]
 
     movzwl 0x18(%rbp), %r11d                 # LD MASK FROM STACK  [SCRBL: r11]
     kmovw  %r11d, %k1                        # SET MASK
+    cmpq $0x0, 0x28(%rbp)                    # TEST ACCUMULATE FLAG
+    jne .LOADC
     vxorps %zmm2, %zmm2, %zmm2
     vxorps %zmm3, %zmm3, %zmm3
     vxorps %zmm4, %zmm4, %zmm4
@@ -65,77 +105,96 @@ asm_gemm:
     vxorps %zmm14, %zmm14, %zmm14
     vxorps %zmm15, %zmm15, %zmm15
     vxorps %zmm16, %zmm16, %zmm16
+    jmp .INITEND
+.LOADC:
+    movq %rdx, %r10                          # LDC
+    movq %r8, %rdx                           # C MATRIX PTR
+    vmovups (%rdx), %zmm2{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm3{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm4{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm5{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm6{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm7{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm8{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm9{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm10{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm11{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm12{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm13{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm14{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm15{%k1}{z}
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    vmovups (%rdx), %zmm16{%k1}{z}
+.INITEND:
 
     # START MATRIX MULTIPLICATION
     xorl %eax, %eax                          # INDEX i
     movq 0x20(%rbp), %r10                    # ID
     movq 0x10(%rbp), %r8                     # PAGE OFFSET DATA
+    movq 0x30(%rbp), %r11                    # A PREFETCH DISTANCE
+    imulq %rdi, %r11                         # DISTANCE * LDA
+    shlq $0x2, %r11                          # A PREFETCH OFFSET IN BYTES
+    testq %r11, %r11                         # TEST PREFETCH DISTANCE
+    jz .NPLOOPBEGIN
 .LOOPBEGIN:
     # LOOP INIT
     cmpl %esi, %eax                          # TEST i < k
     jnb .LOOPEXIT
     # LOOP INIT END
-    vmovups (%rcx), %zmm0{%k1}               # LOAD A COL TO REGISTER
-    # SET MATRIX B
-    movl %eax, %r14d                         # CALLER SAVE
-    movq %r9, %r13                           # MOV BASE PAGE ADDRESS
-    lea (%r8, %r10, 0x8), %r12               # OFFSET
-    movq (%r12), %r12
-    addq %r12, %r13                          # CALLABLE ADDRESS
-    callq *%r13                              # CALL FUNCTION TO SET MAT B
-    movl %r14d, %eax                         # CALLER RESTORE
-    # MATMUL
-    vfmadd231ps %zmm0, %zmm31, %zmm2         # z2 += z0 * z31
-    vfmadd231ps %zmm0, %zmm30, %zmm3         # z3 += z0 * z30
-    vfmadd231ps %zmm0, %zmm29, %zmm4         # z4 += z0 * z29
-    vfmadd231ps %zmm0, %zmm28, %zmm5         # z5 += z0 * z28
-    vfmadd231ps %zmm0, %zmm27, %zmm6         # z6 += z0 * z27
-    vfmadd231ps %zmm0, %zmm26, %zmm7         # z7 += z0 * z26
-    vfmadd231ps %zmm0, %zmm25, %zmm8         # z8 += z0 * z25
-    vfmadd231ps %zmm0, %zmm24, %zmm9         # z9 += z0 * z24
-    vfmadd231ps %zmm0, %zmm23, %zmm10        # z10 += z0 * z23
-    vfmadd231ps %zmm0, %zmm22, %zmm11        # z11 += z0 * z22
-    vfmadd231ps %zmm0, %zmm21, %zmm12        # z12 += z0 * z21
-    vfmadd231ps %zmm0, %zmm20, %zmm13        # z13 += z0 * z20
-    vfmadd231ps %zmm0, %zmm19, %zmm14        # z14 += z0 * z19
-    vfmadd231ps %zmm0, %zmm18, %zmm15        # z15 += z0 * z18
-    vfmadd231ps %zmm0, %zmm17, %zmm16        # z16 += z0 * z17
-    # LOOP CLEANUP                   
-    lea (%rcx, %rdi, 0x4), %rcx              # INCREMENT A MATRIX PTR
-    addl $1, %eax                            # i = i + 1
-    addl $1, %r10d                           # ID = ID + 1
+    prefetcht0 (%rcx, %r11)                  # PREFETCH A COL TO L1
+    prefetcht1 (%rcx, %r11, 0x2)             # PREFETCH A COL TO L2
+    GEMM_K_STEP
     jmp .LOOPBEGIN
-    # LOOP CLEANUP END
+.NPLOOPBEGIN:
+    # LOOP WITHOUT A PREFETCH (DISTANCE 0)
+    cmpl %esi, %eax                          # TEST i < k
+    jnb .LOOPEXIT
+    GEMM_K_STEP
+    jmp .NPLOOPBEGIN
 .LOOPEXIT:
+    movq -0x28(%rbp), %r10                   # [RESTORE LDC FROM STACK]
     movq -0x8(%rbp), %rdx                    # [RESTORE C MATRIX PTR TO STACK]
     vmovups %zmm2, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm3, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm4, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm5, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm6, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm7, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm8, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm9, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm10, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm11, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm12, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm13, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm14, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm15, (%rdx){%k1}
-    lea (%rdx, %rdi, 0x4), %rdx              # INCREMENT C MATRIX PTR
+    lea (%rdx, %r10, 0x4), %rdx              # INCREMENT C MATRIX PTR
     vmovups %zmm16, (%rdx){%k1}
     movq $0x1, %rax                          # SET RETURN VALUE
     # FUNCTION BODY ENDS
@@ -60,6 +60,70 @@ TEST(GEMM, CPP) {
   std::free(C);
 }
 
+TEST(GEMM, CPP_TRANSPOSE) {
+  // row tiles, column tiles and k are not multiples of the register tiles
+  index_t m = 37;
+  index_t n = 19;
+  index_t k = 23;
+
+  float *A = static_cast<float *>(std::malloc(m * k * sizeof(float)));
+  float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
+  float *A_T = static_cast<float *>(std::malloc(m * k * sizeof(float)));
+  float *B_T = static_cast<float *>(std::malloc(n * k * sizeof(float)));
+  float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+
+  for (index_t i = 0; i < m; ++i) {
+    for (index_t j = 0; j < k; ++j) {
+      A[i * k + j] = (i * k + j) % 11 - 5;
+      A_T[j * m + i] = A[i * k + j];
+    }
+  }
+  for (index_t i = 0; i < k; ++i) {
+    for (index_t j = 0; j < n; ++j) {
+      B[i * n + j] = (i * n + j) % 7 - 3;
+      B_T[j * k + i] = B[i * n + j];
+    }
+  }
+  for (index_t i = 0; i < m; ++i) {
+    for (index_t j = 0; j < n; ++j) {
+      C_REF[i * n + j] = 0;
+      for (index_t kk = 0; kk < k; ++kk) {
+        C_REF[i * n + j] += A[i * k + kk] * B[kk * n + j];
+      }
+    }
+  }
+
+  GemmWorkspace workspace;
+  const char modes[] = {'N', 'n', 'T', 't'};
+  for (char transa : modes) {
+    for (char transb : modes) {
+      bool a_t = transa == 'T' || transa == 't';
+      bool b_t = transb == 'T' || transb == 't';
+      // stale values in C must be overwritten
+      for (index_t i = 0; i < m * n; ++i) {
+        C[i] = -1;
+      }
+      gemm<float>(transa, transb, m, n, k, 1.0, a_t ? A_T : A, a_t ? m : k,
+                  b_t ? B_T : B, b_t ? k : n, 0, C, n, workspace);
+      for (index_t i = 0; i < m * n; ++i) {
+        EXPECT_EQ(C_REF[i], C[i]) << transa << transb << " @ " << i;
+      }
+    }
+  }
+  // the workspace is sized by the first transposed B call and reused
+  index_t capacity = workspace.get_capacity();
+  gemm<float>('N', 'T', m, n, k, 1.0, A, k, B_T, k, 0, C, n, workspace);
+  EXPECT_EQ(capacity, workspace.get_capacity());
+
+  std::free(A);
+  std::free(B);
+  std::free(A_T);
+  std::free(B_T);
+  std::free(C);
+  std::free(C_REF);
+}
+
 TEST(GEMM, ASM) {
   index_t m = 10;
   index_t n = 10;
@@ -11,21 +11,9 @@
 #include <chrono>
 
 #include "gemm/gemm.h"
-#include "gemm/kernels/gemm_f32_j1.h"
-#include "gemm/kernels/gemm_f32_j10.h"
-#include "gemm/kernels/gemm_f32_j11.h"
-#include "gemm/kernels/gemm_f32_j12.h"
-#include "gemm/kernels/gemm_f32_j13.h"
-#include "gemm/kernels/gemm_f32_j14.h"
-#include "gemm/kernels/gemm_f32_j15.h"
-#include "gemm/kernels/gemm_f32_j2.h"
-#include "gemm/kernels/gemm_f32_j3.h"
-#include "gemm/kernels/gemm_f32_j4.h"
-#include "gemm/kernels/gemm_f32_j5.h"
-#include "gemm/kernels/gemm_f32_j6.h"
-#include "gemm/kernels/gemm_f32_j7.h"
-#include "gemm/kernels/gemm_f32_j8.h"
-#include "gemm/kernels/gemm_f32_j9.h"
+#include "gemm/gemm_f32.h"
+#include "gemm/kernels.h"
+#include "gemm/pack.h"
 #include "gtest/gtest.h"
 
 TEST(GEMM, f32_j1) {
@@ -37,6 +25,8 @@ TEST(GEMM, f32_j1) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -53,7 +43,10 @@ TEST(GEMM, f32_j1) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j1('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<1, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -63,6 +56,7 @@ TEST(GEMM, f32_j1) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j2) {
@@ -74,6 +68,8 @@ TEST(GEMM, f32_j2) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -90,7 +86,10 @@ TEST(GEMM, f32_j2) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j2('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<2, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -100,6 +99,7 @@ TEST(GEMM, f32_j2) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j3) {
@@ -111,6 +111,8 @@ TEST(GEMM, f32_j3) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -127,7 +129,10 @@ TEST(GEMM, f32_j3) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j3('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<3, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -137,6 +142,7 @@ TEST(GEMM, f32_j3) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j4) {
@@ -148,6 +154,8 @@ TEST(GEMM, f32_j4) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -164,7 +172,10 @@ TEST(GEMM, f32_j4) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j4('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<4, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -174,6 +185,7 @@ TEST(GEMM, f32_j4) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j5) {
@@ -185,6 +197,8 @@ TEST(GEMM, f32_j5) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -201,7 +215,10 @@ TEST(GEMM, f32_j5) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j5('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<5, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -211,6 +228,7 @@ TEST(GEMM, f32_j5) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j6) {
@@ -222,6 +240,8 @@ TEST(GEMM, f32_j6) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -238,7 +258,10 @@ TEST(GEMM, f32_j6) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j6('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<6, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -248,6 +271,7 @@ TEST(GEMM, f32_j6) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j7) {
@@ -259,6 +283,8 @@ TEST(GEMM, f32_j7) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -275,7 +301,10 @@ TEST(GEMM, f32_j7) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j7('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<7, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -285,6 +314,7 @@ TEST(GEMM, f32_j7) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j8) {
@@ -296,6 +326,8 @@ TEST(GEMM, f32_j8) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -312,7 +344,10 @@ TEST(GEMM, f32_j8) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j8('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<8, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -322,6 +357,7 @@ TEST(GEMM, f32_j8) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j9) {
@@ -333,6 +369,8 @@ TEST(GEMM, f32_j9) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -349,7 +387,10 @@ TEST(GEMM, f32_j9) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j9('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<9, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                    A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -359,6 +400,7 @@ TEST(GEMM, f32_j9) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j10) {
@@ -370,6 +412,8 @@ TEST(GEMM, f32_j10) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -386,7 +430,10 @@ TEST(GEMM, f32_j10) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j10('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<10, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                     A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -396,6 +443,7 @@ TEST(GEMM, f32_j10) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j11) {
@@ -407,6 +455,8 @@ TEST(GEMM, f32_j11) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -423,7 +473,10 @@ TEST(GEMM, f32_j11) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j11('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<11, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                     A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -433,6 +486,7 @@ TEST(GEMM, f32_j11) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j12) {
@@ -444,6 +498,8 @@ TEST(GEMM, f32_j12) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -460,7 +516,10 @@ TEST(GEMM, f32_j12) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j12('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<12, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                     A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -469,6 +528,7 @@ TEST(GEMM, f32_j12) {
   std::free(A);
   std::free(B);
   std::free(C);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j13) {
@@ -480,6 +540,8 @@ TEST(GEMM, f32_j13) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -496,7 +558,10 @@ TEST(GEMM, f32_j13) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j13('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<13, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                     A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -506,6 +571,7 @@ TEST(GEMM, f32_j13) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j14) {
@@ -517,6 +583,8 @@ TEST(GEMM, f32_j14) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -533,7 +601,10 @@ TEST(GEMM, f32_j14) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j14('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<14, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                     A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -543,6 +614,7 @@ TEST(GEMM, f32_j14) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
+  std::free(A_PANEL);
 }
 
 TEST(GEMM, f32_j15) {
@@ -554,6 +626,8 @@ TEST(GEMM, f32_j15) {
   float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
   float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
   float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  float *A_PANEL =
+      static_cast<float *>(std::malloc(A_PANEL_ROWS * k * sizeof(float)));
 
   for (index_t i = 0; i < m; ++i) {
     for (index_t j = 0; j < k; ++j) {
@@ -570,7 +644,10 @@ TEST(GEMM, f32_j15) {
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
   gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  gemm_f32_j15('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+  // kernels consume a packed column major A panel
+  pack_a_panel(A, k, m, k, A_PANEL);
+  gemm_f32_kernel<15, A_PANEL_ROWS>('N', 'N', m, n, k, 1.0, A_PANEL,
+                                     A_PANEL_ROWS, B, n, 0, C, n);
 
   for (index_t i = 0; i < m * n; ++i) {
     EXPECT_EQ(C_REF[i], C[i]);
@@ -580,4 +657,45 @@ TEST(GEMM, f32_j15) {
   std::free(B);
   std::free(C);
   std::free(C_REF);
-}
\ No newline at end of file
+  std::free(A_PANEL);
+}
+// the 8x24 and 32x8 tiles trade register rows for columns. shapes cover full
+// tiles as well as row and column remainders
+template <index_t MRows, index_t NCols>
+void test_sgemm_tiled() {
+  const index_t shapes[][3] = {{MRows, NCols, 7},  {37, 50, 19},
+                               {5, 3, 16},         {64, 48, 33},
+                               {MRows - 1, NCols + 1, 1}};
+  for (const auto &shape : shapes) {
+    const index_t m = shape[0];
+    const index_t n = shape[1];
+    const index_t k = shape[2];
+    float *A = static_cast<float *>(std::malloc(m * k * sizeof(float)));
+    float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
+    float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+    float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+    for (index_t i = 0; i < m * k; ++i) {
+      A[i] = i % 13 - 6;
+    }
+    for (index_t i = 0; i < k * n; ++i) {
+      B[i] = i % 7 - 3;
+    }
+    memset(C, 0, m * n * sizeof(float));
+    memset(C_REF, 0, m * n * sizeof(float));
+    gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
+    MARLIN::sgemm_tiled<MRows, NCols>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
+    for (index_t i = 0; i < m * n; ++i) {
+      EXPECT_EQ(C_REF[i], C[i]) << m << "x" << n << "x" << k << " @ " << i;
+    }
+    std::free(A);
+    std::free(B);
+    std::free(C);
+    std::free(C_REF);
+  }
+}
+
+TEST(GEMM, f32_tile_shapes) {
+  test_sgemm_tiled<16, 15>();
+  test_sgemm_tiled<8, 24>();
+  test_sgemm_tiled<32, 8>();
+}
@@ -14,9 +14,10 @@
 #include "gtest/gtest.h"
 #include "jit/jitter.h"
 
-extern "C" index_t asm_gemm(index_t m, index_t k, index_t n, float *a, float *c,
-                            void *p_addr, index_t *offset_data, uint16_t mask,
-                            index_t idx);
+extern "C" index_t asm_gemm(index_t lda, index_t k, index_t ldc, float *a,
+                            float *c, void *p_addr, index_t *offset_data,
+                            uint16_t mask, index_t idx, index_t accumulate,
+                            index_t prefetch_distance);
 
 TEST(JIT, ASM_GEMM) {
   index_t m = 5;
@@ -53,9 +54,9 @@ TEST(JIT, ASM_GEMM) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm(m, k, n, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
-           jitter->get_pmask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  asm_gemm(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+           jitter->get_pmask(m), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -8,6 +8,10 @@
  ******************************************************************************/
 /* Malith Jayaweera
 *******************************************************************************/
+#include <functional>
+#include <thread>
+#include <vector>
+
 #include "gemm/gemm.h"
 #include "gemm/gemm_f32.h"
 #include "gtest/gtest.h"
@@ -15,57 +19,221 @@
 
 using namespace MARLIN;
 
+// fills a matrix of the given size with value(i) for element i
+std::vector<float> make_matrix(index_t size,
+                               std::function<float(index_t)> value) {
+  std::vector<float> matrix(size);
+  for (index_t i = 0; i < size; ++i) {
+    matrix[i] = value(i);
+  }
+  return matrix;
+}
+
+// C (column major, stride ldc) must hold the product of A (column major,
+// stride lda) and B (row major) while the rows of C past m stay untouched
+void verify_gemm(index_t m, index_t n, index_t k, const float *A, index_t lda,
+                 const float *B, const float *C, index_t ldc) {
+  for (index_t j = 0; j < n; ++j) {
+    for (index_t i = 0; i < ldc; ++i) {
+      float expected = -1;
+      if (i < m) {
+        expected = 0;
+        for (index_t kk = 0; kk < k; ++kk) {
+          expected += A[i + kk * lda] * B[kk * n + j];
+        }
+      }
+      EXPECT_EQ(expected, C[i + j * ldc]);
+    }
+  }
+}
+
+// runs the JIT sgemm through a Jitter or a CompiledGemm handle and checks C
+template <typename Code>
+void test_jit_gemm(index_t m, index_t n, index_t k, index_t lda, index_t ldc,
+                   std::vector<float> &A, std::vector<float> &B,
+                   const Code &code) {
+#ifdef ENABLE_JIT
+  std::vector<float> C(ldc * n, -1);
+  sgemm('N', 'N', m, n, k, 1.0, A.data(), lda, B.data(), n, 0, C.data(), ldc,
+        code);
+  verify_gemm(m, n, k, A.data(), lda, B.data(), C.data(), ldc);
+#endif
+}
+
 TEST(JIT, GEMM) {
   index_t m = 3;
   index_t n = 5;
   index_t k = 2;
 
-  float *A = static_cast<float *>(std::malloc(m * k * sizeof(float)));
-  float *B = static_cast<float *>(std::malloc(n * k * sizeof(float)));
-  float *C = static_cast<float *>(std::malloc(m * n * sizeof(float)));
-  float *C_REF = static_cast<float *>(std::malloc(m * n * sizeof(float)));
+  std::vector<float> A = make_matrix(m * k, [](index_t i) { return i + 1; });
+  std::vector<float> B = make_matrix(k * n, [](index_t i) { return i + 1; });
 
-  for (index_t i = 0; i < m; ++i) {
-    for (index_t j = 0; j < k; ++j) {
-      A[i * k + j] = i * k + j + 1;
-    }
-  }
-  for (index_t i = 0; i < k; ++i) {
-    for (index_t j = 0; j < n; ++j) {
-      index_t idx = i * n + j;
-      B[i * n + j] = idx + 1;
-    }
+  // generate code
+  std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+  jitter->generate_code(B.data(), m, k, n);
+  test_jit_gemm(m, n, k, m, m, A, B, jitter);
+
+#ifndef ENABLE_JIT
+  std::vector<float> C(m * n, 0);
+  std::vector<float> C_REF(m * n, 0);
+  gemm<float>('N', 'N', m, n, k, 1.0, A.data(), k, B.data(), n, 0,
+              C_REF.data(), n);
+  sgemm('N', 'N', m, n, k, 1.0, A.data(), k, B.data(), n, 0, C.data(), n);
+  for (index_t i = 0; i < m * n; ++i) {
+    EXPECT_EQ(C_REF[i], C[i]);
   }
+#endif
+}
+
+TEST(JIT, GEMM_K_SEGMENTED) {
+  // k is large enough for the B matrix code to be split in to several L1i
+  // sized segments which accumulate in to C
+  index_t m = 37;
+  index_t n = 47;
+  index_t k = 260;
+
+  std::vector<float> A = make_matrix(m * k, [](index_t i) { return i % 7; });
+  std::vector<float> B =
+      make_matrix(k * n, [](index_t i) { return (i % 5) - 2; });
 
   // generate code
   std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
-  jitter->generate_code(B, m, k, n);
+  jitter->generate_code(B.data(), m, k, n);
+  EXPECT_LT(jitter->get_k_block(), k);
+  test_jit_gemm(m, n, k, m, m, A, B, jitter);
+}
 
-  memset(C, 0, m * n * sizeof(float));
-  memset(C_REF, 0, m * n * sizeof(float));
-#ifdef ENABLE_JIT
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  sgemm('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n, jitter);
-#else
-  gemm<float>('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  sgemm('N', 'N', m, n, k, 1.0, A, k, B, n, 0, C, n);
-#endif
+TEST(JIT, GEMM_PREFETCH_DISTANCE) {
+  // prefetching A ahead must not change the result for any distance
+  index_t m = 100;
+  index_t n = 31;
+  index_t k = 40;
 
-#ifdef ENABLE_JIT
-  // asm: col major & gemm: row major
-  for (index_t i = 0; i < n; ++i) {
-    for (index_t j = 0; j < m; ++j) {
-      EXPECT_EQ(C_REF[j * n + i], C[i * m + j]);
-    }
+  std::vector<float> A = make_matrix(m * k, [](index_t i) { return i % 11; });
+  std::vector<float> B =
+      make_matrix(k * n, [](index_t i) { return (i % 3) - 1; });
+
+  std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+  jitter->generate_code(B.data(), m, k, n);
+  EXPECT_EQ(A_PREFETCH_DISTANCE, jitter->get_prefetch_distance(m));
+  EXPECT_EQ(0, jitter->get_prefetch_distance(16));
+
+  for (index_t distance : {0, 1, 8, 64}) {
+    jitter->set_prefetch_distance(distance);
+    test_jit_gemm(m, n, k, m, m, A, B, jitter);
   }
-#else
-  for (index_t i = 0; i < m * n; ++i) {
-    EXPECT_EQ(C_REF[i], C[i]);
+}
+
+TEST(JIT, GEMM_FUSED) {
+  // {m, n, k} shapes covering tiny, tile aligned and ragged matrices
+  const index_t shapes[][3] = {
+      {3, 5, 2}, {16, 15, 16}, {32, 30, 32}, {37, 47, 29}, {5, 16, 33}};
+
+  for (auto &shape : shapes) {
+    const index_t m = shape[0];
+    const index_t n = shape[1];
+    const index_t k = shape[2];
+
+    std::vector<float> A =
+        make_matrix(m * k, [](index_t i) { return i % 13; });
+    // every third B value is zero to exercise the zero skipping
+    std::vector<float> B = make_matrix(
+        k * n, [](index_t i) { return (i % 3) ? (i % 7) - 3 : 0; });
+
+    std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+    jitter->generate_fused_code(B.data(), m, k, n);
+    EXPECT_NE(nullptr, jitter->get_fused_kernel(m, k, n));
+    EXPECT_EQ(nullptr, jitter->get_fused_kernel(m + 1, k, n));
+    test_jit_gemm(m, n, k, m, m, A, B, jitter);
   }
+}
+
+TEST(JIT, GEMM_FUSED_BUDGET) {
+  // the whole GEMM code of this shape exceeds the budget, hence sgemm falls
+  // back to the k-segmented kernels
+  const index_t m = 64;
+  const index_t n = 128;
+  const index_t k = 128;
+
+  std::vector<float> A = make_matrix(m * k, [](index_t i) { return i % 5; });
+  std::vector<float> B =
+      make_matrix(k * n, [](index_t i) { return (i % 3) - 1; });
+
+  std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+  jitter->generate_fused_code(B.data(), m, k, n);
+  EXPECT_EQ(nullptr, jitter->get_fused_kernel(m, k, n));
+  test_jit_gemm(m, n, k, m, m, A, B, jitter);
+}
+
+TEST(JIT, GEMM_STRIDED) {
+  // A and C are column major views of larger matrices (lda > m, ldc > m).
+  // The fused kernel assumes dense operands and must not be used for them.
+  const index_t m = 21;
+  const index_t n = 37;
+  const index_t k = 30;
+  const index_t lda = m + 11;
+  const index_t ldc = m + 5;
+
+  std::vector<float> A = make_matrix(
+      lda * k, [=](index_t i) { return i % lda < m ? i % 7 : 1e6; });
+  std::vector<float> B =
+      make_matrix(k * n, [](index_t i) { return (i % 5) - 2; });
+
+  std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+  jitter->generate_fused_code(B.data(), m, k, n);
+  test_jit_gemm(m, n, k, lda, ldc, A, B, jitter);
+
+#ifdef ENABLE_JIT
+  std::vector<float> C(ldc * n);
+  EXPECT_THROW(sgemm('N', 'N', m, n, k, 1.0, A.data(), m - 1, B.data(), n, 0,
+                     C.data(), ldc, jitter),
+               std::invalid_argument);
 #endif
+}
+
+TEST(JIT, GEMM_DYNAMIC_M) {
+  // one jitter generated without m serves every batch size
+  const index_t n = 33;
+  const index_t k = 20;
+  const index_t max_m = 70;
+
+  std::vector<float> A =
+      make_matrix(max_m * k, [](index_t i) { return i % 9; });
+  std::vector<float> B =
+      make_matrix(k * n, [](index_t i) { return (i % 5) - 2; });
+
+  std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+  jitter->generate_code(B.data(), k, n);
+
+  for (index_t m : {1, 7, 16, 23, 64, 70}) {
+    test_jit_gemm(m, n, k, m, m, A, B, jitter);
+  }
+}
 
-  std::free(A);
-  std::free(B);
-  std::free(C);
-  std::free(C_REF);
-}
\ No newline at end of file
+TEST(JIT, GEMM_COMPILED_THREADS) {
+  // worker threads share one trivially copyable handle to the same code
+  const index_t m = 45;
+  const index_t n = 40;
+  const index_t k = 24;
+  const index_t num_threads = 4;
+
+  std::vector<float> A = make_matrix(m * k, [](index_t i) { return i % 6; });
+  std::vector<float> B =
+      make_matrix(k * n, [](index_t i) { return (i % 4) - 1; });
+
+  std::shared_ptr<Jitter<float>> jitter = std::make_shared<Jitter<float>>();
+  jitter->generate_code(B.data(), k, n);
+  const CompiledGemm compiled = jitter->get_compiled();
+
+  std::vector<std::thread> workers;
+  for (index_t t = 0; t < num_threads; ++t) {
+    workers.emplace_back([&]() {
+      for (index_t r = 0; r < 100; ++r) {
+        test_jit_gemm(m, n, k, m, m, A, B, compiled);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
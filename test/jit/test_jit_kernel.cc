@@ -10,12 +10,11 @@
 *******************************************************************************/
 #include <chrono>
 
-#include "gemm/asm_kernels.h"
 #include "gemm/gemm.h"
 #include "gtest/gtest.h"
 #include "jit/jitter.h"
 
-TEST(ASM_GEMM, f32_j1) {
+TEST(JIT_GEMM, remainder_f32_j1) {
   constexpr index_t m = 16;
   constexpr index_t n = 1;
   constexpr index_t k = 15;
@@ -44,9 +43,11 @@ TEST(ASM_GEMM, f32_j1) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j1(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -61,7 +62,7 @@ TEST(ASM_GEMM, f32_j1) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j2) {
+TEST(JIT_GEMM, remainder_f32_j2) {
   constexpr index_t m = 16;
   constexpr index_t n = 2;
   constexpr index_t k = 15;
@@ -90,9 +91,11 @@ TEST(ASM_GEMM, f32_j2) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j2(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -107,7 +110,7 @@ TEST(ASM_GEMM, f32_j2) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j3) {
+TEST(JIT_GEMM, remainder_f32_j3) {
   constexpr index_t m = 16;
   constexpr index_t n = 3;
   constexpr index_t k = 15;
@@ -136,9 +139,11 @@ TEST(ASM_GEMM, f32_j3) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j3(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -153,7 +158,7 @@ TEST(ASM_GEMM, f32_j3) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j4) {
+TEST(JIT_GEMM, remainder_f32_j4) {
   constexpr index_t m = 16;
   constexpr index_t n = 4;
   constexpr index_t k = 15;
@@ -182,9 +187,11 @@ TEST(ASM_GEMM, f32_j4) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j4(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -199,7 +206,7 @@ TEST(ASM_GEMM, f32_j4) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j5) {
+TEST(JIT_GEMM, remainder_f32_j5) {
   constexpr index_t m = 16;
   constexpr index_t n = 5;
   constexpr index_t k = 15;
@@ -228,9 +235,11 @@ TEST(ASM_GEMM, f32_j5) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j5(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -245,7 +254,7 @@ TEST(ASM_GEMM, f32_j5) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j6) {
+TEST(JIT_GEMM, remainder_f32_j6) {
   constexpr index_t m = 16;
   constexpr index_t n = 6;
   constexpr index_t k = 15;
@@ -274,9 +283,11 @@ TEST(ASM_GEMM, f32_j6) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j6(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -290,7 +301,7 @@ TEST(ASM_GEMM, f32_j6) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j7) {
+TEST(JIT_GEMM, remainder_f32_j7) {
   constexpr index_t m = 16;
   constexpr index_t n = 7;
   constexpr index_t k = 15;
@@ -319,9 +330,11 @@ TEST(ASM_GEMM, f32_j7) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j7(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -336,7 +349,7 @@ TEST(ASM_GEMM, f32_j7) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j8) {
+TEST(JIT_GEMM, remainder_f32_j8) {
   constexpr index_t m = 16;
   constexpr index_t n = 8;
   constexpr index_t k = 15;
@@ -365,9 +378,11 @@ TEST(ASM_GEMM, f32_j8) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j8(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -382,7 +397,7 @@ TEST(ASM_GEMM, f32_j8) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j9) {
+TEST(JIT_GEMM, remainder_f32_j9) {
   constexpr index_t m = 16;
   constexpr index_t n = 9;
   constexpr index_t k = 15;
@@ -411,9 +426,11 @@ TEST(ASM_GEMM, f32_j9) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j9(m, k, n, A, C, jitter->get_p_addr(),
-                  jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -428,7 +445,7 @@ TEST(ASM_GEMM, f32_j9) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j10) {
+TEST(JIT_GEMM, remainder_f32_j10) {
   constexpr index_t m = 16;
   constexpr index_t n = 10;
   constexpr index_t k = 10;
@@ -457,9 +474,11 @@ TEST(ASM_GEMM, f32_j10) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j10(m, k, n, A, C, jitter->get_p_addr(),
-                   jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -473,7 +492,7 @@ TEST(ASM_GEMM, f32_j10) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j11) {
+TEST(JIT_GEMM, remainder_f32_j11) {
   constexpr index_t m = 16;
   constexpr index_t n = 11;
   constexpr index_t k = 15;
@@ -502,9 +521,11 @@ TEST(ASM_GEMM, f32_j11) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j11(m, k, n, A, C, jitter->get_p_addr(),
-                   jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -519,7 +540,7 @@ TEST(ASM_GEMM, f32_j11) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j12) {
+TEST(JIT_GEMM, remainder_f32_j12) {
   constexpr index_t m = 16;
   constexpr index_t n = 12;
   constexpr index_t k = 15;
@@ -548,9 +569,11 @@ TEST(ASM_GEMM, f32_j12) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j12(m, k, n, A, C, jitter->get_p_addr(),
-                   jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -565,7 +588,7 @@ TEST(ASM_GEMM, f32_j12) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j13) {
+TEST(JIT_GEMM, remainder_f32_j13) {
   constexpr index_t m = 16;
   constexpr index_t n = 13;
   constexpr index_t k = 15;
@@ -594,9 +617,11 @@ TEST(ASM_GEMM, f32_j13) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j13(m, k, n, A, C, jitter->get_p_addr(),
-                   jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -611,7 +636,7 @@ TEST(ASM_GEMM, f32_j13) {
   std::free(C_REF);
 }
 
-TEST(ASM_GEMM, f32_j14) {
+TEST(JIT_GEMM, remainder_f32_j14) {
   constexpr index_t m = 16;
   constexpr index_t n = 14;
   constexpr index_t k = 15;
@@ -640,9 +665,11 @@ TEST(ASM_GEMM, f32_j14) {
 
   memset(C, 0, m * n * sizeof(float));
   memset(C_REF, 0, m * n * sizeof(float));
-  gemm<float>('T', 'N', m, n, k, 1.0, A, k, B, n, 0, C_REF, n);
-  asm_gemm_f32_j14(m, k, n, A, C, jitter->get_p_addr(),
-                   jitter->get_offset_data(), jitter->get_mask(), idx);
+  gemm<float>('T', 'N', m, n, k, 1.0, A, m, B, n, 0, C_REF, n);
+  gemm_kernel_t kernel = jitter->get_remainder_kernel();
+  ASSERT_NE(nullptr, kernel);
+  kernel(m, k, m, A, C, jitter->get_p_addr(), jitter->get_offset_data(),
+         jitter->get_mask(), idx, 0, 0);
 
   // asm: col major & gemm: row major
   for (index_t i = 0; i < n; ++i) {
@@ -33,28 +33,9 @@ TEST(JIT, Winograd) {
   initialize_tensor(input);
   initialize_tensor(filter);
 
-#ifdef ENABLE_JIT
-  const index_t in_tile_area = 16;
-  std::shared_ptr<Tensor<float>> transformed_filter =
-      std::make_shared<Tensor<float>>();
-  transformed_filter->resize({out_channels, in_channels, in_tile_area});
-  float *transformed_filter_data = transformed_filter->mutable_data();
-  const float *filter_data = filter->data();
-
-  winograd.transform_kernel(filter_data, out_channels, in_channels,
-                            transformed_filter_data);
-
   std::shared_ptr<WinoJitter<float>> jitter =
-      std::make_shared<WinoJitter<float>>();
-  jitter->generate_code(transformed_filter_data, in_tile_area, in_channels,
-                        out_channels);
-#endif
-
-#ifdef ENABLE_JIT
-  winograd.run(input, filter, output, jitter);
-#else
-  winograd.run(input, filter, output);
-#endif
+      generate_wino_jitter(winograd, filter);
+  run_winograd(winograd, input, filter, output, jitter);
 
   std::shared_ptr<Tensor<float>> output_d = std::make_shared<Tensor<float>>();
   std::unique_ptr<conv2d::DirectConvolver<float>> direct_convolver =
@@ -66,4 +47,184 @@ TEST(JIT, Winograd) {
   direct_convolver->run(filter.get(), input.get(), output_d.get());
 
   verify_execution(output_d.get(), output.get());
-}
\ No newline at end of file
+}
+template <wino_k_t W, wino_o_t O>
+void test_winograd(index_t batch, index_t in_channels, index_t in_height,
+                   index_t in_width, index_t out_channels, bool fused = false,
+                   index_t block_tiles = 0,
+                   const std::vector<index_t> &padding = {0, 0, 0, 0}) {
+  typedef Winograd<float, W, O> Engine;
+  Engine winograd;
+  winograd.set_fused(fused);
+  winograd.set_block_tiles(block_tiles);
+  winograd.set_padding(padding);
+  std::shared_ptr<Tensor<float>> input = std::make_shared<Tensor<float>>();
+  std::shared_ptr<Tensor<float>> filter = std::make_shared<Tensor<float>>(true);
+  std::shared_ptr<Tensor<float>> output = std::make_shared<Tensor<float>>();
+  input->resize({batch, in_channels, in_height, in_width});
+  filter->resize({out_channels, in_channels, Engine::KERNEL, Engine::KERNEL});
+  initialize_tensor(input);
+  initialize_tensor(filter);
+
+  std::shared_ptr<WinoJitter<float>> jitter =
+      generate_wino_jitter(winograd, filter);
+  run_winograd(winograd, input, filter, output, jitter);
+
+  std::shared_ptr<Tensor<float>> output_d = std::make_shared<Tensor<float>>();
+  conv2d::DirectConvolver<float> direct_convolver;
+  direct_convolver.set_padding(padding);
+  direct_convolver.set_stride({1, 1});
+  direct_convolver.run(filter.get(), input.get(), output_d.get());
+
+  ASSERT_EQ(output_d->get_dims(), output->get_dims());
+  verify_execution(output_d.get(), output.get());
+}
+
+TEST(JIT, Winograd2x2) {
+  // partial blocks of 16 tiles, more than 16 tiles per row, odd sizes
+  test_winograd<WINO_K_3x3, WINO_O_2x2>(1, 17, 9, 75, 3);
+  test_winograd<WINO_K_3x3, WINO_O_2x2>(3, 2, 37, 11, 19);
+}
+
+TEST(JIT, Winograd4x4) {
+  EXPECT_EQ(40, (Winograd<float, WINO_K_3x3, WINO_O_4x4>::TILE_AREA));
+  // exact tiles, partial tiles and more than 16 tiles per row
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(2, 3, 18, 18, 10);
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(1, 5, 13, 23, 7);
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(1, 17, 9, 75, 3);
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(3, 2, 70, 12, 19);
+}
+
+TEST(JIT, Winograd5x5) {
+  EXPECT_EQ(40, (Winograd<float, WINO_K_5x5, WINO_O_2x2>::TILE_AREA));
+  EXPECT_EQ(64, (Winograd<float, WINO_K_5x5, WINO_O_4x4>::TILE_AREA));
+  test_winograd<WINO_K_5x5, WINO_O_2x2>(2, 3, 20, 20, 10);
+  test_winograd<WINO_K_5x5, WINO_O_2x2>(1, 17, 9, 75, 3);
+  test_winograd<WINO_K_5x5, WINO_O_4x4>(2, 3, 20, 20, 10);
+  test_winograd<WINO_K_5x5, WINO_O_4x4>(1, 5, 13, 23, 7);
+  test_winograd<WINO_K_5x5, WINO_O_4x4>(3, 2, 70, 12, 19);
+}
+
+TEST(JIT, WinogradFused) {
+  // automatic block size
+  test_winograd<WINO_K_3x3, WINO_O_2x2>(2, 3, 20, 20, 10, true);
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(1, 17, 9, 75, 3, true);
+  // blocks narrower than a vector, partial vectors and a partial last block
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(2, 5, 21, 37, 9, true, 3);
+  test_winograd<WINO_K_3x3, WINO_O_2x2>(1, 4, 13, 75, 6, true, 17);
+  test_winograd<WINO_K_5x5, WINO_O_4x4>(3, 2, 30, 70, 19, true, 5);
+}
+
+TEST(JIT, WinogradThreads) {
+  typedef Winograd<float, WINO_K_3x3, WINO_O_4x4> Engine;
+  const index_t batch = 3;
+  const index_t in_channels = 5;
+  const index_t out_channels = 7;
+  std::shared_ptr<Tensor<float>> input = std::make_shared<Tensor<float>>();
+  std::shared_ptr<Tensor<float>> filter = std::make_shared<Tensor<float>>(true);
+  input->resize({batch, in_channels, 23, 41});
+  filter->resize({out_channels, in_channels, Engine::KERNEL, Engine::KERNEL});
+  initialize_tensor(input);
+  initialize_tensor(filter);
+
+  Engine reference;
+  std::shared_ptr<WinoJitter<float>> jitter =
+      generate_wino_jitter(reference, filter);
+
+  std::shared_ptr<Tensor<float>> expected = std::make_shared<Tensor<float>>();
+  for (index_t threads : {1, 2, 5}) {
+    Engine winograd;
+    EXPECT_EQ(static_cast<index_t>(omp_get_max_threads()),
+              winograd.get_num_threads());
+    winograd.set_num_threads(threads);
+    EXPECT_EQ(threads, winograd.get_num_threads());
+    std::shared_ptr<Tensor<float>> output = std::make_shared<Tensor<float>>();
+    run_winograd(winograd, input, filter, output, jitter);
+    if (threads == 1) {
+      expected = output;
+      continue;
+    }
+    // every element is computed the same way whatever the team size
+    ASSERT_EQ(expected->get_dims(), output->get_dims());
+    for (index_t i = 0; i < output->size(); ++i) {
+      ASSERT_EQ(expected->data()[i], output->data()[i]);
+    }
+  }
+}
+
+TEST(JIT, WinogradPlan) {
+  typedef WinogradPlan<float, WINO_K_3x3, WINO_O_4x4> Plan;
+  const std::vector<index_t> input_dims = {2, 5, 15, 38};
+  std::shared_ptr<Tensor<float>> filter = std::make_shared<Tensor<float>>(true);
+  filter->resize({9, 5, 3, 3});
+  initialize_tensor(filter);
+  Plan plan(filter, input_dims);
+  EXPECT_EQ(std::vector<index_t>({2, 9, 13, 36}), plan.get_output_dims());
+  EXPECT_EQ(4u, plan.get_geometry().tiles_h);
+  EXPECT_EQ(9u, plan.get_geometry().tiles_w);
+
+  conv2d::DirectConvolver<float> direct_convolver;
+  direct_convolver.set_padding({0, 0, 0, 0});
+  direct_convolver.set_stride({1, 1});
+  std::shared_ptr<Tensor<float>> input = std::make_shared<Tensor<float>>();
+  input->resize(input_dims);
+  // the prepared filter and scratch are reused across inputs and settings
+  for (index_t i = 0; i < 3; ++i) {
+    if (i == 2) plan.set_fused(true);
+    initialize_tensor(input);
+    std::shared_ptr<Tensor<float>> output = std::make_shared<Tensor<float>>();
+    plan.execute(input, output);
+    std::shared_ptr<Tensor<float>> output_d =
+        std::make_shared<Tensor<float>>();
+    direct_convolver.run(filter.get(), input.get(), output_d.get());
+    ASSERT_EQ(output_d->get_dims(), output->get_dims());
+    verify_execution(output_d.get(), output.get());
+  }
+
+  std::shared_ptr<Tensor<float>> other = std::make_shared<Tensor<float>>();
+  other->resize({2, 5, 16, 38});
+  std::shared_ptr<Tensor<float>> output = std::make_shared<Tensor<float>>();
+  EXPECT_THROW(plan.execute(other, output), std::invalid_argument);
+  EXPECT_THROW(Plan(filter, {2, 4, 15, 38}), std::invalid_argument);
+}
+
+TEST(JIT, WinogradPadding) {
+  // "same" padding, asymmetric padding and padding wider than the filter
+  test_winograd<WINO_K_3x3, WINO_O_2x2>(2, 3, 17, 21, 5, false, 0,
+                                        {1, 1, 1, 1});
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(2, 3, 17, 21, 5, false, 0,
+                                        {2, 0, 1, 3});
+  test_winograd<WINO_K_3x3, WINO_O_4x4>(1, 4, 9, 40, 6, true, 16,
+                                        {1, 1, 1, 1});
+  test_winograd<WINO_K_5x5, WINO_O_4x4>(1, 3, 13, 19, 4, true, 0,
+                                        {2, 2, 2, 2});
+  test_winograd<WINO_K_5x5, WINO_O_2x2>(1, 2, 6, 7, 3, false, 0,
+                                        {7, 1, 0, 6});
+
+  // a plan re-derives its geometry when the padding changes
+  typedef WinogradPlan<float, WINO_K_3x3, WINO_O_4x4> Plan;
+  const std::vector<index_t> input_dims = {1, 3, 10, 14};
+  std::shared_ptr<Tensor<float>> filter = std::make_shared<Tensor<float>>(true);
+  filter->resize({4, 3, 3, 3});
+  initialize_tensor(filter);
+  Plan plan(filter, input_dims);
+  plan.set_same_padding();
+  EXPECT_EQ(std::vector<index_t>({1, 4, 10, 14}), plan.get_output_dims());
+  std::shared_ptr<Tensor<float>> input = std::make_shared<Tensor<float>>();
+  input->resize(input_dims);
+  initialize_tensor(input);
+  std::shared_ptr<Tensor<float>> output = std::make_shared<Tensor<float>>();
+  plan.execute(input, output);
+  conv2d::DirectConvolver<float> direct_convolver;
+  direct_convolver.set_padding({1, 1, 1, 1});
+  direct_convolver.set_stride({1, 1});
+  std::shared_ptr<Tensor<float>> output_d = std::make_shared<Tensor<float>>();
+  direct_convolver.run(filter.get(), input.get(), output_d.get());
+  verify_execution(output_d.get(), output.get());
+
+  EXPECT_THROW(plan.set_padding({1, 1}), std::invalid_argument);
+  Winograd<float, WINO_K_5x5, WINO_O_2x2> winograd;
+  winograd.set_padding({0, 0, 1, 0});
+  EXPECT_THROW(winograd.get_geometry({1, 1, 3, 3}, {1, 1, 5, 5}),
+               std::invalid_argument);
+}
@@ -9,6 +9,7 @@
 /* Malith Jayaweera
 *******************************************************************************/
 #include <immintrin.h>
+#include <string.h>
 
 #include <chrono>
 
@@ -36,4 +37,120 @@ TEST(Matrix, Transpose_4x4) {
   transpose4x4<float>(mat_4x4, mat_4x4_tp, h, w);
   _mm_free(mat_4x4);
   _mm_free(mat_4x4_tp);
-}
\ No newline at end of file
+}
+TEST(Matrix, Transpose_16x16) {
+  float *mat = static_cast<float *>(
+      _mm_malloc(16 * 16 * sizeof(float), ALIGN_BYTE_SIZE));
+  float *mat_tp = static_cast<float *>(
+      _mm_malloc(16 * 16 * sizeof(float), ALIGN_BYTE_SIZE));
+
+  for (index_t i = 0; i < 16 * 16; ++i) {
+    mat[i] = i;
+  }
+
+  __m512 rows[16];
+  for (index_t i = 0; i < 16; ++i) {
+    rows[i] = _mm512_load_ps(mat + i * 16);
+  }
+  transpose16x16(rows);
+  for (index_t i = 0; i < 16; ++i) {
+    _mm512_store_ps(mat_tp + i * 16, rows[i]);
+  }
+
+  for (index_t i = 0; i < 16; ++i) {
+    for (index_t j = 0; j < 16; ++j) {
+      EXPECT_EQ(mat[j * 16 + i], mat_tp[i * 16 + j]);
+    }
+  }
+  _mm_free(mat);
+  _mm_free(mat_tp);
+}
+TEST(Matrix, Transpose_blocked) {
+  // edge blocks in both dimensions and padded leading dimensions
+  index_t h = 37;
+  index_t w = 21;
+  index_t ld_src = w + 3;
+  index_t ld_dst = h + 5;
+  float *mat = static_cast<float *>(
+      _mm_malloc(h * ld_src * sizeof(float), ALIGN_BYTE_SIZE));
+  float *mat_tp = static_cast<float *>(
+      _mm_malloc(w * ld_dst * sizeof(float), ALIGN_BYTE_SIZE));
+
+  for (index_t i = 0; i < h * ld_src; ++i) {
+    mat[i] = i;
+  }
+  for (index_t i = 0; i < w * ld_dst; ++i) {
+    mat_tp[i] = -1;
+  }
+
+  transpose_blocked(mat, h, w, ld_src, mat_tp, ld_dst);
+
+  for (index_t i = 0; i < w; ++i) {
+    for (index_t j = 0; j < ld_dst; ++j) {
+      // padding of the destination is left untouched
+      float expected = j < h ? mat[j * ld_src + i] : -1;
+      EXPECT_EQ(expected, mat_tp[i * ld_dst + j]);
+    }
+  }
+  _mm_free(mat);
+  _mm_free(mat_tp);
+}
+TEST(Matrix, Transpose_parallel_stream) {
+  // spans several cache tiles, with aligned full rows taking the streaming
+  // stores and edge blocks falling back to masked stores
+  index_t h = 150;
+  index_t w = 131;
+  index_t ld_dst = 160;
+  float *mat =
+      static_cast<float *>(_mm_malloc(h * w * sizeof(float), ALIGN_BYTE_SIZE));
+  float *mat_tp = static_cast<float *>(
+      _mm_malloc(w * ld_dst * sizeof(float), ALIGN_BYTE_SIZE));
+  float *mat_ref = static_cast<float *>(
+      _mm_malloc(w * ld_dst * sizeof(float), ALIGN_BYTE_SIZE));
+
+  for (index_t i = 0; i < h * w; ++i) {
+    mat[i] = i;
+  }
+  memset(mat_tp, 0, w * ld_dst * sizeof(float));
+  memset(mat_ref, 0, w * ld_dst * sizeof(float));
+
+  transpose_blocked(mat, h, w, w, mat_ref, ld_dst);
+  for (index_t i = 0; i < w; ++i) {
+    for (index_t j = 0; j < h; ++j) {
+      EXPECT_EQ(mat[j * w + i], mat_ref[i * ld_dst + j]);
+    }
+  }
+  transpose_blocked<true>(mat, h, w, w, mat_tp, ld_dst);
+  EXPECT_EQ(0, memcmp(mat_ref, mat_tp, w * ld_dst * sizeof(float)));
+  memset(mat_tp, 0, w * ld_dst * sizeof(float));
+  transpose_parallel(mat, h, w, w, mat_tp, ld_dst);
+  EXPECT_EQ(0, memcmp(mat_ref, mat_tp, w * ld_dst * sizeof(float)));
+  memset(mat_tp, 0, w * ld_dst * sizeof(float));
+  transpose_parallel<true>(mat, h, w, w, mat_tp, ld_dst);
+  EXPECT_EQ(0, memcmp(mat_ref, mat_tp, w * ld_dst * sizeof(float)));
+
+  _mm_free(mat);
+  _mm_free(mat_tp);
+  _mm_free(mat_ref);
+}
+TEST(Matrix, Transpose_inplace) {
+  index_t n = 37;
+  index_t ld = 40;
+  float *mat = static_cast<float *>(
+      _mm_malloc(n * ld * sizeof(float), ALIGN_BYTE_SIZE));
+
+  for (index_t i = 0; i < n * ld; ++i) {
+    mat[i] = i;
+  }
+
+  transpose_inplace(mat, n, ld);
+
+  for (index_t i = 0; i < n; ++i) {
+    for (index_t j = 0; j < ld; ++j) {
+      // padding columns keep their values
+      float expected = j < n ? j * ld + i : i * ld + j;
+      EXPECT_EQ(expected, mat[i * ld + j]);
+    }
+  }
+  _mm_free(mat);
+}
@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mem/allocator.h"
+#include "tensor/tensor.h"
+
+TEST(Memory, ArenaAlignment) {
+  WorkspaceScope scope;
+  Arena& arena = Arena::get_thread_arena();
+  for (index_t bytes : {1, 3, 64, 65, 1000, 4096, 100000}) {
+    void* ptr = arena.allocate(bytes);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % ALIGN_BYTE_SIZE);
+    EXPECT_LE(bytes, arena.get_block_size(ptr));
+    memset(ptr, 0xff, bytes);
+  }
+}
+
+TEST(Memory, ArenaSizeClassReuse) {
+  WorkspaceScope scope;
+  Arena& arena = Arena::get_thread_arena();
+  void* first = arena.allocate(1000);
+  arena.free(first);
+  // same size class (1024 bytes) is served from the free list
+  void* second = arena.allocate(700);
+  EXPECT_EQ(first, second);
+  void* third = arena.allocate(700);
+  EXPECT_NE(second, third);
+}
+
+TEST(Memory, ArenaWorkspaceScope) {
+  Arena& arena = Arena::get_thread_arena();
+  void* outer;
+  {
+    WorkspaceScope scope;
+    outer = arena.allocate(256);
+    void* inner;
+    {
+      WorkspaceScope nested;
+      inner = arena.allocate(512);
+      // larger than a chunk
+      arena.allocate(2 * ARENA_CHUNK_BYTES);
+    }
+    // the nested scope rewinds to where it started
+    EXPECT_EQ(inner, arena.allocate(512));
+    EXPECT_NE(outer, inner);
+  }
+  const index_t reserved = arena.get_reserved_bytes();
+  for (index_t i = 0; i < 10; ++i) {
+    WorkspaceScope scope;
+    EXPECT_EQ(outer, arena.allocate(256));
+    arena.allocate(2 * ARENA_CHUNK_BYTES);
+  }
+  // repeated scopes reuse the retained chunks
+  EXPECT_EQ(reserved, arena.get_reserved_bytes());
+}
+
+TEST(Memory, ArenaScopeReclaimsReusedBlocks) {
+  Arena& arena = Arena::get_thread_arena();
+  WorkspaceScope outer;
+  void* freed = arena.allocate(1000);
+  arena.free(freed);
+  {
+    // the freed block precedes the scope, hence the scope does not reuse it
+    WorkspaceScope scope;
+    EXPECT_NE(freed, arena.allocate(1000));
+  }
+  EXPECT_EQ(freed, arena.allocate(1000));
+}
+
+TEST(Memory, ArenaAllocatorOutlivesScope) {
+  std::shared_ptr<IAllocator<float>> allocator =
+      GetAllocator<float>(ARENA_ALLOCATOR);
+  Arena& arena = Arena::get_thread_arena();
+  float* owned;
+  void* scoped;
+  {
+    WorkspaceScope scope;
+    scoped = arena.allocate(400);
+    owned = static_cast<float*>(allocator->allocate(100));
+    for (index_t i = 0; i < 100; ++i) {
+      owned[i] = i;
+    }
+  }
+  {
+    // the bump pointer continues past the owned block
+    WorkspaceScope scope;
+    float* other = static_cast<float*>(arena.allocate(400));
+    EXPECT_TRUE(other + 100 <= owned || owned + 100 <= other);
+    memset(other, 0, 400);
+  }
+  for (index_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, owned[i]);
+  }
+  // the released scoped block before it is reused through the free list
+  void* reused = arena.allocate(400);
+  EXPECT_EQ(scoped, reused);
+  arena.free(reused);
+  allocator->free(owned);
+}
+
+TEST(Memory, ArenaThreads) {
+  // each thread owns an arena, hence concurrent scopes do not interfere
+  std::vector<std::thread> threads;
+  std::vector<int> valid(4, 0);
+  for (index_t t = 0; t < 4; ++t) {
+    threads.emplace_back([t, &valid]() {
+      WorkspaceScope scope;
+      std::shared_ptr<IAllocator<float>> allocator =
+          GetAllocator<float>(ARENA_ALLOCATOR);
+      float* data = static_cast<float*>(allocator->allocate(1024));
+      for (index_t i = 0; i < 1024; ++i) {
+        data[i] = t;
+      }
+      std::this_thread::yield();
+      bool ok = true;
+      for (index_t i = 0; i < 1024; ++i) {
+        ok = ok && data[i] == t;
+      }
+      allocator->free(data);
+      valid[t] = ok;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int ok : valid) {
+    EXPECT_TRUE(ok);
+  }
+}
+
+TEST(Memory, ArenaForeignThreadFree) {
+  std::shared_ptr<IAllocator<float>> allocator =
+      GetAllocator<float>(ARENA_ALLOCATOR);
+  // a block freed by another thread returns to the arena it came from
+  WorkspaceScope scope;
+  float* data = static_cast<float*>(allocator->allocate(300));
+  std::thread([&]() { allocator->free(data); }).join();
+  EXPECT_EQ(data, allocator->allocate(300));
+
+  // blocks outlive the thread that allocated them
+  float* orphan = nullptr;
+  std::thread([&]() {
+    orphan = static_cast<float*>(allocator->allocate(1024));
+    for (index_t i = 0; i < 1024; ++i) {
+      orphan[i] = i;
+    }
+  }).join();
+  orphan = static_cast<float*>(allocator->resize(orphan, 4096));
+  for (index_t i = 0; i < 1024; ++i) {
+    EXPECT_EQ(i, orphan[i]);
+  }
+  allocator->free(orphan);
+}
+
+TEST(Memory, ArenaAllocatorTensor) {
+  WorkspaceScope scope;
+  std::shared_ptr<IAllocator<float>> allocator =
+      GetAllocator<float>(ARENA_ALLOCATOR);
+  float* data = static_cast<float*>(allocator->allocate(10));
+  for (index_t i = 0; i < 10; ++i) {
+    data[i] = i;
+  }
+  // resizing beyond the size class moves the data
+  data = static_cast<float*>(allocator->resize(data, 1000));
+  for (index_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, data[i]);
+  }
+  allocator->free(data);
+
+  Tensor<float> tensor(allocator);
+  tensor.resize({2, 3, 4});
+  for (index_t i = 0; i < tensor.size(); ++i) {
+    tensor.mutable_data()[i] = i;
+  }
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(tensor.data()) % ALIGN_BYTE_SIZE);
+  EXPECT_EQ(23, tensor.data()[23]);
+}
+
+TEST(Memory, HugePageAllocator) {
+  // the hugetlbfs pool is usually empty, hence both configurations exercise
+  // the transparent huge page fallback at least once
+  for (bool use_hugetlb : {false, true}) {
+    HugePageAllocator<float> allocator(use_hugetlb, true);
+    float* data = static_cast<float*>(allocator.allocate(1000));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(data) % ALIGN_BYTE_SIZE);
+    // mappings are rounded up to whole huge pages
+    EXPECT_EQ(HUGE_PAGE_BYTES - ALIGN_BYTE_SIZE, allocator.get_capacity(data));
+    for (index_t i = 0; i < 1000; ++i) {
+      data[i] = i;
+    }
+    EXPECT_EQ(data, allocator.resize(data, 2000));
+    data = static_cast<float*>(allocator.resize(data, HUGE_PAGE_BYTES));
+    for (index_t i = 0; i < 1000; ++i) {
+      EXPECT_EQ(i, data[i]);
+    }
+    allocator.free(data);
+  }
+}
+
+TEST(Memory, NumaAllocator) {
+  for (int node : {-1, 0}) {
+    std::shared_ptr<IAllocator<float>> allocator =
+        std::make_shared<NumaAllocator<float>>(node);
+    Tensor<float> tensor(allocator);
+    tensor.resize({4, 256, 256});
+    for (index_t i = 0; i < tensor.size(); ++i) {
+      tensor.mutable_data()[i] = i;
+    }
+    EXPECT_EQ(tensor.size() - 1, tensor.data()[tensor.size() - 1]);
+  }
+  Tensor<float> tensor(GetAllocator<float>(HUGE_PAGE_ALLOCATOR));
+  tensor.resize({2, 3});
+  tensor.mutable_data()[5] = 5;
+  EXPECT_EQ(5, tensor.data()[5]);
+}
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#include <stdint.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mem/allocator.h"
+#include "mem/buffer.h"
+#include "tensor/tensor.h"
+
+TEST(Memory, AllocatorResizeAlignment) {
+  // interleaved allocations move the blocks during realloc, landing at
+  // different offsets from the 64 byte boundary
+  std::shared_ptr<IAllocator<float>> allocator = GetCPUAllocator<float>();
+  index_t size = 3;
+  float* data = static_cast<float*>(allocator->allocate(size));
+  for (index_t i = 0; i < size; ++i) {
+    data[i] = i;
+  }
+  std::vector<void*> fillers;
+  for (index_t iter = 0; iter < 64; ++iter) {
+    fillers.push_back(std::malloc(16 + 8 * iter));
+    const index_t new_size = size + 7 + iter;
+    data = static_cast<float*>(allocator->resize(data, new_size));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(data) % 64);
+    for (index_t i = 0; i < size; ++i) {
+      ASSERT_EQ(i, data[i]) << "iteration " << iter;
+    }
+    for (index_t i = size; i < new_size; ++i) {
+      data[i] = i;
+    }
+    size = new_size;
+  }
+  allocator->free(data);
+  for (void* filler : fillers) {
+    std::free(filler);
+  }
+}
+
+TEST(Memory, BufferCapacity) {
+  Buffer<float> buffer(GetCPUAllocator<float>());
+  buffer.resize(100 * sizeof(float));
+  EXPECT_EQ(100 * sizeof(float), buffer.size());
+  EXPECT_EQ(100 * sizeof(float), buffer.capacity());
+  float* data = buffer.mutable_data();
+  for (index_t i = 0; i < 100; ++i) {
+    data[i] = i;
+  }
+  // shrinking and growing within the capacity keeps the memory
+  buffer.resize(10 * sizeof(float));
+  EXPECT_EQ(10 * sizeof(float), buffer.size());
+  EXPECT_EQ(data, buffer.mutable_data());
+  buffer.resize(100 * sizeof(float));
+  EXPECT_EQ(data, buffer.mutable_data());
+  // growth is geometric and preserves the data
+  buffer.resize(101 * sizeof(float));
+  EXPECT_EQ(101 * sizeof(float), buffer.size());
+  EXPECT_EQ(200 * sizeof(float), buffer.capacity());
+  for (index_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, buffer.data()[i]);
+  }
+  EXPECT_THROW(buffer.allocate(10), std::runtime_error);
+
+  float external[16];
+  Buffer<float> view(GetCPUAllocator<float>(), external, sizeof(external));
+  EXPECT_TRUE(view.resize(8 * sizeof(float)));
+  EXPECT_EQ(external, view.mutable_data());
+  EXPECT_THROW(view.resize(sizeof(external) + 1), std::runtime_error);
+  EXPECT_THROW(view.allocate(4), std::runtime_error);
+}
+
+TEST(Memory, TensorResizeReusesCapacity) {
+  Tensor<float> tensor;
+  tensor.resize({1, 3, 32, 32});
+  const float* data = tensor.data();
+  // dynamic shapes within the first allocation reuse it
+  tensor.resize({1, 3, 16, 16});
+  EXPECT_EQ(data, tensor.data());
+  EXPECT_EQ(3 * 16 * 16, tensor.size());
+  tensor.resize({1, 3, 32, 32});
+  EXPECT_EQ(data, tensor.data());
+  tensor.resize({2, 3, 32, 32});
+  tensor.mutable_data()[tensor.size() - 1] = 1;
+  EXPECT_EQ(2 * 3 * 32 * 32, tensor.size());
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mem/memory_planner.h"
+#include "tensor/tensor.h"
+
+TEST(MemoryPlanner, ChainReusesMemory) {
+  // op i consumes activation i and produces activation i + 1
+  const std::vector<index_t> sizes = {4096, 16384, 8192, 16384, 1024};
+  MemoryPlanner<float> planner;
+  std::vector<index_t> ids;
+  for (index_t i = 0; i < sizes.size(); ++i) {
+    const index_t first = i == 0 ? 0 : i - 1;
+    ids.push_back(planner.add(sizes[i], first, i));
+  }
+  planner.plan();
+  for (index_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(0, planner.get_offset(ids[i]) % ALIGN_BYTE_SIZE);
+    EXPECT_LE(planner.get_offset(ids[i]) + sizes[i], planner.get_arena_size());
+  }
+  // only neighbouring activations are alive at once
+  EXPECT_EQ(16384 + 8192, planner.get_arena_size());
+  EXPECT_LT(planner.get_arena_size(), planner.get_unplanned_size());
+}
+
+TEST(MemoryPlanner, LiveTensorsDoNotOverlap) {
+  MemoryPlanner<float> planner;
+  struct Interval {
+    index_t nbytes, first, last;
+  };
+  std::vector<Interval> intervals;
+  for (index_t i = 0; i < 64; ++i) {
+    const index_t first = (i * 7) % 20;
+    intervals.push_back({100 + (i * 37) % 900, first, first + i % 5});
+    planner.add(intervals.back().nbytes, intervals.back().first,
+                intervals.back().last);
+  }
+  planner.plan();
+  for (index_t a = 0; a < intervals.size(); ++a) {
+    for (index_t b = a + 1; b < intervals.size(); ++b) {
+      if (intervals[a].first > intervals[b].last ||
+          intervals[b].first > intervals[a].last)
+        continue;
+      const index_t begin_a = planner.get_offset(a);
+      const index_t begin_b = planner.get_offset(b);
+      EXPECT_TRUE(begin_a + intervals[a].nbytes <= begin_b ||
+                  begin_b + intervals[b].nbytes <= begin_a)
+          << "tensors " << a << " and " << b << " overlap";
+    }
+  }
+}
+
+TEST(MemoryPlanner, BindTensors) {
+  MemoryPlanner<float> planner;
+  const index_t input = planner.add({1, 3, 8, 8}, 0, 0);
+  const index_t hidden = planner.add({1, 16, 8, 8}, 0, 1);
+  const index_t output = planner.add({1, 3, 8, 8}, 1, 1);
+  EXPECT_THROW(planner.get_buffer(input), std::runtime_error);
+  planner.plan();
+  // input and output are never alive together
+  EXPECT_EQ(planner.get_offset(input), planner.get_offset(output));
+
+  Tensor<float> in(planner.get_buffer(input));
+  Tensor<float> out(planner.get_buffer(output));
+  std::shared_ptr<IBuffer<float>> hidden_buffer = planner.get_buffer(hidden);
+  Tensor<float> mid(hidden_buffer);
+  in.reshape({1, 3, 8, 8});
+  mid.resize({1, 16, 8, 8});
+  out.reshape({1, 3, 8, 8});
+  EXPECT_EQ(in.data(), out.data());
+  EXPECT_NE(in.data(), mid.data());
+  for (index_t i = 0; i < mid.size(); ++i) {
+    mid.mutable_data()[i] = i;
+  }
+  for (index_t i = 0; i < in.size(); ++i) {
+    in.mutable_data()[i] = -1;
+  }
+  for (index_t i = 0; i < mid.size(); ++i) {
+    ASSERT_EQ(i, mid.data()[i]);
+  }
+  EXPECT_THROW(mid.resize({1, 17, 8, 8}), std::invalid_argument);
+  EXPECT_THROW(hidden_buffer->resize(17 * 64 * sizeof(float)),
+               std::runtime_error);
+  EXPECT_THROW(planner.add(64, 0, 0), std::runtime_error);
+  EXPECT_THROW(planner.get_offset(3), std::out_of_range);
+}
@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#include <memory>
+
+#include "../utils/test_utils.h"
+#include "conv/direct/direct_convolver.h"
+#include "gtest/gtest.h"
+#include "tensor/reorder.h"
+
+namespace {
+// element (b, c, h, w) of a tensor in any layout
+float at(const Tensor<float>& t, index_t b, index_t c, index_t h, index_t w) {
+  const index_t channels = t.dim(1);
+  const index_t height = t.dim(2);
+  const index_t width = t.dim(3);
+  const index_t hw = height * width;
+  const index_t p = h * width + w;
+  switch (t.get_layout()) {
+    case LAYOUT_NHWC:
+      return t.data()[(b * hw + p) * channels + c];
+    case LAYOUT_NCHW16C: {
+      const index_t blocks = RoundUp(channels, CHANNEL_BLOCK_SIZE) / 16;
+      return t.data()[((b * blocks + c / 16) * hw + p) * 16 + c % 16];
+    }
+    default:
+      return t.data()[(b * channels + c) * hw + p];
+  }
+}
+
+void expect_same(const Tensor<float>& a, const Tensor<float>& b) {
+  for (index_t n = 0; n < a.dim(0); ++n)
+    for (index_t c = 0; c < a.dim(1); ++c)
+      for (index_t h = 0; h < a.dim(2); ++h)
+        for (index_t w = 0; w < a.dim(3); ++w)
+          ASSERT_EQ(at(a, n, c, h, w), at(b, n, c, h, w))
+              << n << " " << c << " " << h << " " << w;
+}
+}  // namespace
+
+TEST(Reorder, BlockedSize) {
+  Tensor<float> t;
+  t.set_layout(LAYOUT_NCHW16C);
+  t.resize({2, 20, 3, 5});
+  EXPECT_EQ(2 * 32 * 3 * 5, t.size());
+  EXPECT_EQ(20, t.dim(1));
+  Tensor<float> matrix;
+  matrix.resize({4, 4});
+  EXPECT_THROW(matrix.set_layout(LAYOUT_NHWC), std::invalid_argument);
+}
+
+TEST(Reorder, RoundTrip) {
+  const layout_t layouts[] = {LAYOUT_NCHW, LAYOUT_NHWC, LAYOUT_NCHW16C};
+  // channel counts and image sizes with partial blocks and tiles
+  const std::vector<std::vector<index_t>> shapes = {
+      {1, 3, 5, 7}, {2, 16, 8, 8}, {2, 37, 9, 11}, {1, 70, 13, 10}};
+  for (const std::vector<index_t>& shape : shapes) {
+    std::shared_ptr<Tensor<float>> src = std::make_shared<Tensor<float>>();
+    src->resize(shape);
+    initialize_tensor(src);
+    for (layout_t first : layouts) {
+      for (layout_t second : layouts) {
+        Tensor<float> a;
+        Tensor<float> b;
+        Tensor<float> back;
+        reorder(*src, &a, first);
+        reorder(a, &b, second);
+        EXPECT_EQ(second, b.get_layout());
+        expect_same(*src, b);
+        reorder(b, &back, LAYOUT_NCHW);
+        for (index_t i = 0; i < src->size(); ++i) {
+          ASSERT_EQ(src->data()[i], back.data()[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST(Reorder, StridedView) {
+  // a channel slice and a subsampled crop are gathered before reordering
+  std::shared_ptr<Tensor<float>> src = std::make_shared<Tensor<float>>();
+  src->resize({2, 40, 9, 12});
+  initialize_tensor(src);
+  const std::vector<std::shared_ptr<Tensor<float>>> views = {
+      src->view({0, 3, 0, 0}, {2, 21, 9, 12}),
+      src->view({1, 2, 1, 0}, {1, 17, 4, 6}, {1, 2, 2, 2})};
+  const layout_t layouts[] = {LAYOUT_NCHW, LAYOUT_NHWC, LAYOUT_NCHW16C};
+  for (const std::shared_ptr<Tensor<float>>& view : views) {
+    ASSERT_FALSE(view->is_contiguous());
+    for (layout_t layout : layouts) {
+      Tensor<float> dst;
+      reorder(*view, &dst, layout);
+      EXPECT_EQ(layout, dst.get_layout());
+      EXPECT_EQ(view->get_dims(), dst.get_dims());
+      for (index_t n = 0; n < view->dim(0); ++n)
+        for (index_t c = 0; c < view->dim(1); ++c)
+          for (index_t h = 0; h < view->dim(2); ++h)
+            for (index_t w = 0; w < view->dim(3); ++w)
+              ASSERT_EQ(view->data()[n * view->stride(0) +
+                                     c * view->stride(1) +
+                                     h * view->stride(2) +
+                                     w * view->stride(3)],
+                        at(dst, n, c, h, w));
+    }
+  }
+}
+
+TEST(Reorder, BlockedPaddingIsZero) {
+  std::shared_ptr<Tensor<float>> src = std::make_shared<Tensor<float>>();
+  src->resize({1, 20, 4, 4});
+  initialize_tensor(src);
+  for (layout_t from : {LAYOUT_NCHW, LAYOUT_NHWC}) {
+    Tensor<float> source;
+    Tensor<float> blocked;
+    reorder(*src, &source, from);
+    reorder(source, &blocked, LAYOUT_NCHW16C);
+    const float* last_block = blocked.data() + 16 * 16;
+    for (index_t p = 0; p < 16; ++p) {
+      for (index_t c = 4; c < 16; ++c) {
+        EXPECT_EQ(0.f, last_block[p * 16 + c]);
+      }
+    }
+  }
+}
+
+TEST(Reorder, ConvolverLayout) {
+  conv2d::DirectConvolver<float> convolver;
+  convolver.set_padding({0, 0, 0, 0});
+  convolver.set_stride({1, 1});
+  EXPECT_EQ(LAYOUT_NCHW, convolver.get_preferred_layout());
+  std::shared_ptr<Tensor<float>> input = std::make_shared<Tensor<float>>();
+  std::shared_ptr<Tensor<float>> filter = std::make_shared<Tensor<float>>();
+  input->resize({1, 2, 5, 5});
+  filter->resize({1, 2, 3, 3});
+  initialize_tensor(input);
+  initialize_tensor(filter);
+  Tensor<float> nhwc;
+  Tensor<float> output;
+  reorder(*input, &nhwc, LAYOUT_NHWC);
+  EXPECT_THROW(convolver.run(filter.get(), &nhwc, &output),
+               std::invalid_argument);
+  Tensor<float> nchw;
+  Tensor<float> expected;
+  reorder(nhwc, &nchw, convolver.get_preferred_layout());
+  convolver.run(filter.get(), &nchw, &output);
+  convolver.run(filter.get(), input.get(), &expected);
+  verify_execution(&expected, &output);
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Copyright (c) Malith Jayaweera - All rights reserved.                       *
+ * This file is part of the MARLIN library.                                    *
+ *                                                                             *
+ * For information on the license, see the LICENSE file.                       *
+ * Further information: https://github.com/malithj/marlin/                     *
+ * SPDX-License-Identifier: BSD-3-Clause                                       *
+ ******************************************************************************/
+/* Malith Jayaweera
+*******************************************************************************/
+#include <marlin>
+
+#include "../utils/test_utils.h"
+#include "conv/direct/direct_convolver.h"
+#include "gtest/gtest.h"
+
+namespace {
+// dense copy of a (possibly strided) 4D tensor
+std::shared_ptr<Tensor<float>> copy(const Tensor<float>& t) {
+  std::shared_ptr<Tensor<float>> dense = std::make_shared<Tensor<float>>();
+  dense->resize(t.get_dims());
+  float* out = dense->mutable_data();
+  for (index_t b = 0; b < t.dim(0); ++b)
+    for (index_t c = 0; c < t.dim(1); ++c)
+      for (index_t h = 0; h < t.dim(2); ++h)
+        for (index_t w = 0; w < t.dim(3); ++w)
+          *out++ = t.data()[b * t.stride(0) + c * t.stride(1) +
+                            h * t.stride(2) + w * t.stride(3)];
+  return dense;
+}
+}  // namespace
+
+TEST(TensorView, SharesMemory) {
+  std::shared_ptr<Tensor<float>> t = std::make_shared<Tensor<float>>();
+  t->resize({2, 4, 6, 8});
+  for (index_t i = 0; i < t->size(); ++i) {
+    t->mutable_data()[i] = i;
+  }
+  EXPECT_TRUE(t->is_contiguous());
+  std::shared_ptr<Tensor<float>> v = t->view({1, 1, 2, 1}, {1, 2, 3, 3},
+                                             {1, 2, 1, 3});
+  EXPECT_FALSE(v->is_contiguous());
+  EXPECT_EQ(std::vector<index_t>({192, 96, 8, 3}), v->get_strides());
+  EXPECT_EQ(192 + 48 + 16 + 1, v->data()[0]);
+  // the view aliases the parent
+  v->mutable_data()[v->stride(1) + v->stride(3)] = -1;
+  EXPECT_EQ(-1, t->data()[192 + 3 * 48 + 16 + 4]);
+  // views of views compose offsets and strides
+  std::shared_ptr<Tensor<float>> w = v->view({0, 1, 0, 1}, {1, 1, 2, 2});
+  EXPECT_EQ(-1, w->data()[0]);
+  EXPECT_EQ(w->get_strides(), v->get_strides());
+
+  EXPECT_THROW(t->view({0, 0, 0, 0}, {1, 1, 7, 1}), std::out_of_range);
+  EXPECT_THROW(t->view({0, 3, 0, 0}, {1, 2, 1, 1}, {1, 1, 1, 1}),
+               std::out_of_range);
+  EXPECT_THROW(v->resize({1, 2, 3, 3}), std::runtime_error);
+  EXPECT_THROW(v->clear(), std::runtime_error);
+  // a contiguous view (batch slice) can be reshaped within its range
+  std::shared_ptr<Tensor<float>> batch = t->view({1, 0, 0, 0}, {1, 4, 6, 8});
+  EXPECT_TRUE(batch->is_contiguous());
+  batch->reshape({4, 48});
+  EXPECT_EQ(192, batch->data()[0]);
+  EXPECT_THROW(batch->reshape({5, 48}), std::invalid_argument);
+}
+
+TEST(TensorView, GemmLeadingDimensions) {
+  // C[4:20, 8:40] = A[2:18, 0:24] * B[5:29, 1:33] through ld parameters
+  std::shared_ptr<Tensor<float>> a = std::make_shared<Tensor<float>>();
+  std::shared_ptr<Tensor<float>> b = std::make_shared<Tensor<float>>();
+  std::shared_ptr<Tensor<float>> c = std::make_shared<Tensor<float>>();
+  a->resize({20, 30});
+  b->resize({32, 40});
+  c->resize({24, 48});
+  for (index_t i = 0; i < a->size(); ++i) a->mutable_data()[i] = i % 7;
+  for (index_t i = 0; i < b->size(); ++i) b->mutable_data()[i] = i % 5;
+  c->clear();
+  std::shared_ptr<Tensor<float>> av = a->view({2, 0}, {16, 24});
+  std::shared_ptr<Tensor<float>> bv = b->view({5, 1}, {24, 32});
+  std::shared_ptr<Tensor<float>> cv = c->view({4, 8}, {16, 32});
+  gemm<float>('N', 'N', 16, 32, 24, 1, av->mutable_data(), av->stride(0),
+              bv->mutable_data(), bv->stride(0), 0, cv->mutable_data(),
+              cv->stride(0));
+  for (index_t i = 0; i < c->dim(0); ++i) {
+    for (index_t j = 0; j < c->dim(1); ++j) {
+      float expected = 0;
+      if (i >= 4 && i < 20 && j >= 8 && j < 40) {
+        for (index_t k = 0; k < 24; ++k) {
+          expected += a->data()[(i - 4 + 2) * 30 + k] *
+                      b->data()[(k + 5) * 40 + j - 8 + 1];
+        }
+      }
+      ASSERT_EQ(expected, c->data()[i * 48 + j]) << i << ", " << j;
+    }
+  }
+}
+
+TEST(TensorView, ConvolutionOnViews) {
+  std::shared_ptr<Tensor<float>> input = std::make_shared<Tensor<float>>();
+  std::shared_ptr<Tensor<float>> filter = std::make_shared<Tensor<float>>(true);
+  input->resize({3, 4, 24, 24});
+  filter->resize({5, 2, 3, 3});
+  initialize_tensor(input);
+  initialize_tensor(filter);
+  // second batch, channels 1 and 2, a 14 x 17 crop
+  std::shared_ptr<Tensor<float>> crop =
+      input->view({1, 1, 3, 2}, {1, 2, 14, 17});
+  std::shared_ptr<Tensor<float>> dense = copy(*crop);
+
+  conv2d::DirectConvolver<float> direct;
+  direct.set_padding({1, 1, 1, 1});
+  direct.set_stride({1, 1});
+  Tensor<float> expected;
+  Tensor<float> actual;
+  direct.run(filter.get(), dense.get(), &expected);
+  direct.run(filter.get(), crop.get(), &actual);
+  verify_execution(&expected, &actual);
+
+  // winograd reads the crop and writes channels 2 to 6 of a larger output
+  direct.set_padding({0, 0, 0, 0});
+  direct.run(filter.get(), dense.get(), &expected);
+  std::shared_ptr<Tensor<float>> output = std::make_shared<Tensor<float>>();
+  output->resize({1, 8, 12, 15});
+  std::shared_ptr<Tensor<float>> group = output->view({0, 2, 0, 0},
+                                                      {1, 5, 12, 15});
+  Winograd<float, WINO_K_3x3, WINO_O_2x2> winograd;
+  std::shared_ptr<WinoJitter<float>> jitter =
+      generate_wino_jitter(winograd, filter);
+  run_winograd(winograd, crop, filter, group, jitter);
+  verify_execution(&expected, copy(*group).get());
+
+  // every other row and column in, every other column out, through both the
+  // staged and the fused pipeline
+  std::shared_ptr<Tensor<float>> strided =
+      input->view({2, 1, 1, 0}, {1, 2, 11, 12}, {1, 1, 2, 2});
+  direct.run(filter.get(), copy(*strided).get(), &expected);
+  output->resize({1, 5, 9, 21});
+  std::shared_ptr<Tensor<float>> columns =
+      output->view({0, 0, 0, 1}, {1, 5, 9, 10}, {1, 1, 1, 2});
+  for (bool fused : {false, true}) {
+    winograd.set_fused(fused);
+    run_winograd(winograd, strided, filter, columns, jitter);
+    verify_execution(&expected, copy(*columns).get());
+  }
+}
@@ -12,6 +12,7 @@
 #define __TEST_UTILS_H_
 
 #include "gtest/gtest.h"
+#include "jit/wino_jitter.h"
 #include "tensor/tensor.h"
 
 template <typename T>
@@ -61,4 +62,40 @@ void verify_execution(const Tensor<T>* expected, const Tensor<T>* actual) {
     }
   }
 }
-#endif
\ No newline at end of file
+
+// transforms the filter with the given Winograd engine and generates the
+// WinoJitter code of the transformed filter (nullptr without the JIT)
+template <typename Engine>
+std::shared_ptr<WinoJitter<float>> generate_wino_jitter(
+    Engine& engine, const std::shared_ptr<Tensor<float>> filter) {
+#ifdef ENABLE_JIT
+  const index_t out_channels = filter->dim(0);
+  const index_t in_channels = filter->dim(1);
+  std::shared_ptr<Tensor<float>> transformed_filter =
+      std::make_shared<Tensor<float>>();
+  transformed_filter->resize({out_channels, in_channels, Engine::TILE_AREA});
+  engine.transform_kernel(filter->data(), out_channels, in_channels,
+                          transformed_filter->mutable_data());
+  std::shared_ptr<WinoJitter<float>> jitter =
+      std::make_shared<WinoJitter<float>>();
+  jitter->generate_code(transformed_filter->mutable_data(), Engine::TILE_AREA,
+                        in_channels, out_channels);
+  return jitter;
+#else
+  return nullptr;
+#endif
+}
+
+// runs the Winograd engine through the jitter when the JIT is enabled
+template <typename Engine>
+void run_winograd(Engine& engine, const std::shared_ptr<Tensor<float>> input,
+                  const std::shared_ptr<Tensor<float>> filter,
+                  std::shared_ptr<Tensor<float>> output,
+                  std::shared_ptr<WinoJitter<float>> jitter) {
+#ifdef ENABLE_JIT
+  engine.run(input, filter, output, jitter);
+#else
+  engine.run(input, filter, output);
+#endif
+}
+#endif
@@ -112,7 +112,7 @@ int main(int argc, char *argv[]) {
 
 #ifdef ENABLE_JIT
   if (mode == 0) {
-    const index_t in_tile_area = 16;
+    const index_t in_tile_area = winograd.TILE_AREA;
     std::shared_ptr<Tensor<float>> transformed_filter =
         std::make_shared<Tensor<float>>();
     transformed_filter->resize({out_channels, in_channels, in_tile_area});